@@ -27,11 +27,13 @@ void ofApp::setup() {
     std::cout << "Place images in: " << inputFolder << std::endl;
     std::cout << "Output will be saved to: " << outputFolder << std::endl;
     std::cout << "Press ENTER to process all images" << std::endl;
+    std::cout << "Press C to cancel processing" << std::endl;
     std::cout << "Press SPACE to process one at a time" << std::endl;
     std::cout << "Press R to rescan input folder" << std::endl;
 }
 
 void ofApp::scanInputFolder() {
+    if (batchMode) return;
     jobs.clear();
     currentJobIndex = -1;
 
@@ -77,8 +79,6 @@ void ofApp::processNext() {
 
     if (currentJobIndex < 0) {
         statusLabel = "All images processed!";
-        isProcessing = false;
-        batchMode = false;
         return;
     }
 
@@ -86,21 +86,17 @@ void ofApp::processNext() {
     auto& job = jobs[currentJobIndex];
     statusLabel = "Processing: " + job.filename;
 
-    // Load image
-    ofImage img;
-    if (!img.load(job.inputPath)) {
+    // Load image (pixels only, the codec does not need a texture)
+    ofPixels pixels;
+    if (!ofLoadImage(pixels, job.inputPath)) {
         job.processed = true;
         job.success = false;
         job.error = "Failed to load image";
         std::cout << "Failed to load: " << job.inputPath << std::endl;
-
-        if (batchMode) {
-            processNext();
-        }
         return;
     }
 
-    currentPreview = img;
+    currentPreview.setFromPixels(pixels);
 
     // Get current preset
     std::string presetName = presetNames[presetIndex];
@@ -110,36 +106,26 @@ void ofApp::processNext() {
     codec.setConfig(preset.codecConfig);
 
     // Process
-    auto buffer = codec.encodeToBuffer(img);
-    if (!buffer.empty()) {
-        auto result = codec.decodeFromBuffer(buffer);
-        if (result.success) {
-            currentResult = result.image;
-
-            // Apply effects if enabled
-            if (applyEffects) {
-                for (const auto& e : preset.effects) {
-                    ofxGlicEffects::applyEffect(currentResult, e);
-                }
-                effects.apply(currentResult);
-            }
+    if (codec.glitch(pixels, resultPixels)) {
+        // Apply effects if enabled
+        if (applyEffects) {
+            std::vector<ofxGlicEffect> allEffects = preset.effects;
+            allEffects.insert(allEffects.end(), effects.getEffects().begin(), effects.getEffects().end());
+            ofxGlicEffects::applyEffects(resultPixels, allEffects, codec.getWorkspace(), codec.getNumThreads());
+        }
 
-            // Save result
-            currentResult.save(job.outputPath);
+        // Save result
+        ofSaveImage(resultPixels, job.outputPath);
+        currentResult.setFromPixels(resultPixels);
 
-            job.processed = true;
-            job.success = true;
-            std::cout << "Processed: " << job.filename << " -> " << job.outputPath << std::endl;
-        } else {
-            job.processed = true;
-            job.success = false;
-            job.error = result.error;
-            std::cout << "Processing failed: " << job.filename << " - " << result.error << std::endl;
-        }
+        job.processed = true;
+        job.success = true;
+        std::cout << "Processed: " << job.filename << " -> " << job.outputPath << std::endl;
     } else {
         job.processed = true;
         job.success = false;
-        job.error = "Encoding failed";
+        job.error = codec.getLastError();
+        std::cout << "Processing failed: " << job.filename << " - " << job.error << std::endl;
     }
 
     // Update progress
@@ -150,18 +136,75 @@ void ofApp::processNext() {
     progressLabel = ofToString(processed) + "/" + ofToString(jobs.size());
 
     isProcessing = false;
+}
 
-    if (batchMode) {
-        processNext();
+void ofApp::processAll() {
+    if (batchMode) return;
+
+    // Unprocessed images run on the thread pool; the window stays responsive
+    std::vector<std::string> paths;
+    batchJobIndices.clear();
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (!jobs[i].processed) {
+            paths.push_back(jobs[i].inputPath);
+            batchJobIndices.push_back(i);
+        }
     }
+    if (paths.empty()) {
+        statusLabel = "All images processed!";
+        return;
+    }
+
+    // Saved as <name>_glitched.png, like processNext()
+    std::vector<ofxGlicBatchJob> batchJobs = ofxGlicBatchProcessor::makeJobs(paths, outputFolder);
+
+    ofxGlicPreset preset = ofxGlicPresets::instance().getPreset(presetNames[presetIndex]);
+    std::vector<ofxGlicEffect> extraEffects;
+    if (applyEffects) {
+        extraEffects = effects.getEffects();
+    } else {
+        preset.effects.clear();
+    }
+
+    batchMode = batch.start(std::move(batchJobs), preset, extraEffects);
+    statusLabel = "Processing " + ofToString(paths.size()) + " images";
 }
 
-void ofApp::processAll() {
-    batchMode = true;
-    processNext();
+void ofApp::syncBatchProgress() {
+    bool finished = !batch.isRunning();
+    if (finished) batch.wait();
+
+    for (size_t i = 0; i < batchJobIndices.size(); i++) {
+        auto& job = jobs[batchJobIndices[i]];
+        auto state = batch.getJobState(i);
+        if (state == ofxGlicBatchJob::State::Running) {
+            currentJobIndex = batchJobIndices[i];
+        }
+        job.processed = state == ofxGlicBatchJob::State::Done || state == ofxGlicBatchJob::State::Failed;
+        job.success = state == ofxGlicBatchJob::State::Done;
+        // Errors are only readable once the batch has stopped
+        if (finished && state == ofxGlicBatchJob::State::Failed) {
+            job.error = batch.getJobs()[i].error;
+            std::cout << "Processing failed: " << job.filename << " - " << job.error << std::endl;
+        }
+    }
+
+    int processed = 0;
+    for (const auto& j : jobs) {
+        if (j.processed) processed++;
+    }
+    progressLabel = ofToString(processed) + "/" + ofToString(jobs.size());
+
+    if (finished) {
+        batchMode = false;
+        statusLabel = batch.getNumFailed() ? ofToString(batch.getNumFailed()) + " images failed" : "All images processed!";
+    }
 }
 
 void ofApp::update() {
+    if (batchMode) {
+        syncBatchProgress();
+    }
 }
 
 void ofApp::draw() {
@@ -220,7 +263,7 @@ void ofApp::draw() {
 
     // Instructions
     ofSetColor(255);
-    ofDrawBitmapString("ENTER: Process all | SPACE: Process one | R: Rescan | 1-0: Presets", margin, ofGetHeight() - 20);
+    ofDrawBitmapString("ENTER: Process all | C: Cancel | SPACE: Process one | R: Rescan | 1-0: Presets", margin, ofGetHeight() - 20);
 
     // Draw GUI
     gui.draw();
@@ -229,8 +272,11 @@ void ofApp::draw() {
 void ofApp::keyPressed(int key) {
     if (key == OF_KEY_RETURN) {
         processAll();
+    } else if ((key == 'c' || key == 'C') && batchMode) {
+        batch.cancel();
+        statusLabel = "Cancelling...";
     } else if (key == ' ') {
-        batchMode = false;
+        if (batchMode) return;
         processNext();
     } else if (key == 'r' || key == 'R') {
         scanInputFolder();
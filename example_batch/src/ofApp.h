@@ -25,18 +25,22 @@ private:
     void scanInputFolder();
     void processNext();
     void processAll();
+    void syncBatchProgress();
     void applyPresetToAll(const std::string& presetName);
 
     ofxGlicCodec codec;
     ofxGlicEffects effects;
+    ofxGlicBatchProcessor batch;
 
     std::vector<BatchJob> jobs;
+    std::vector<size_t> batchJobIndices;  // jobs index of each batch job
     int currentJobIndex = -1;
     bool isProcessing = false;
     bool batchMode = false;
 
     ofImage currentPreview;
     ofImage currentResult;
+    ofPixels resultPixels;
 
     std::string inputFolder;
     std::string outputFolder;
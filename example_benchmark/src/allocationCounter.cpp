@@ -0,0 +1,28 @@
+#include "allocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Kept in its own file so the replacement operators are never inlined into callers
+
+namespace {
+    std::atomic<size_t> allocationCount{0};
+}
+
+size_t getAllocationCount() {
+    return allocationCount.load();
+}
+
+void* operator new(size_t size) {
+    allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
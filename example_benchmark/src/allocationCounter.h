@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Number of heap allocations made by the process so far
+// Counted by a replacement global operator new in allocationCounter.cpp.
+size_t getAllocationCount();
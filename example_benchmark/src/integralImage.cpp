@@ -0,0 +1,101 @@
+#include "integralImage.h"
+#include "ofxGlicPixels.h"
+#include <algorithm>
+
+namespace {
+    // sums[y + 1][x + 1] = sums[y][x + 1] + the running sum of row y up to x
+    template<int NumChannels, int Stride>
+    void buildSums(const uint8_t* data, int width, int height, uint32_t* sums) {
+        const size_t rowSums = size_t(width + 1) * NumChannels;
+        std::fill(sums, sums + rowSums, 0u);
+        for (int y = 0; y < height; y++) {
+            const uint8_t* p = data + size_t(y) * width * Stride;
+            const uint32_t* above = sums + size_t(y) * rowSums + NumChannels;
+            uint32_t* out = sums + size_t(y + 1) * rowSums;
+            uint32_t run[NumChannels] = {};
+            std::fill(out, out + NumChannels, 0u);
+            out += NumChannels;
+            for (int x = 0; x < width; x++, p += Stride, above += NumChannels, out += NumChannels) {
+                for (int c = 0; c < NumChannels; c++) {
+                    run[c] += p[c];
+                    out[c] = above[c] + run[c];
+                }
+            }
+        }
+    }
+}
+
+bool IntegralImage::build(const ofPixels& pixels) {
+    ofxGlic::kernels::EffectLayout layout;
+    if (!ofxGlic::kernels::getEffectLayout(pixels.getPixelFormat(), layout)) return false;
+
+    width_ = int(pixels.getWidth());
+    height_ = int(pixels.getHeight());
+    numChannels_ = layout.isGray() ? 1 : 3;
+    format_ = pixels.getPixelFormat();
+    layout_ = layout;
+    sums_.resize(size_t(width_ + 1) * (height_ + 1) * numChannels_);
+
+    const uint8_t* data = pixels.getData();
+    switch (layout.stride) {
+        case 1: buildSums<1, 1>(data, width_, height_, sums_.data()); break;
+        case 2: buildSums<1, 2>(data, width_, height_, sums_.data()); break;
+        case 3: buildSums<3, 3>(data, width_, height_, sums_.data()); break;
+        case 4: buildSums<3, 4>(data, width_, height_, sums_.data()); break;
+        default: break;
+    }
+    return true;
+}
+
+uint32_t IntegralImage::getSum(int channel, int x0, int y0, int x1, int y1) const {
+    x0 = std::max(0, x0);
+    y0 = std::max(0, y0);
+    x1 = std::min(width_, x1);
+    y1 = std::min(height_, y1);
+    if (channel < 0 || channel >= numChannels_ || x1 <= x0 || y1 <= y0) return 0;
+    return at(channel, x1, y1) - at(channel, x0, y1) - at(channel, x1, y0) + at(channel, x0, y0);
+}
+
+void IntegralImage::getMean(int x0, int y0, int x1, int y1, uint8_t* mean) const {
+    x0 = std::max(0, x0);
+    y0 = std::max(0, y0);
+    x1 = std::min(width_, x1);
+    y1 = std::min(height_, y1);
+    uint32_t count = x1 > x0 && y1 > y0 ? uint32_t(x1 - x0) * uint32_t(y1 - y0) : 0;
+    for (int c = 0; c < numChannels_; c++) {
+        mean[c] = count > 0 ? uint8_t(getSum(c, x0, y0, x1, y1) / count) : 0;
+    }
+}
+
+bool IntegralImage::pixelate(ofPixels& pixels, const ofRectangle& region, int blockWidth,
+                                    int blockHeight) const {
+    if (int(pixels.getWidth()) != width_ || int(pixels.getHeight()) != height_ || pixels.getPixelFormat() != format_) {
+        return false;
+    }
+    int x0, y0, x1, y1;
+    if (!ofxGlic::clipRegion(region, width_, height_, x0, y0, x1, y1)) return true;
+    blockWidth = std::max(1, blockWidth);
+    blockHeight = std::max(1, blockHeight);
+
+    // Each block row's first row is filled block by block, then copied down
+    const int stride = layout_.stride;
+    uint8_t* data = pixels.getData();
+    uint8_t mean[3];
+    for (int by = y0; by < y1; by += blockHeight) {
+        int ey = std::min(y1, by + blockHeight);
+        uint8_t* top = data + (size_t(by) * width_ + x0) * stride;
+        for (int bx = x0; bx < x1; bx += blockWidth) {
+            int ex = std::min(x1, bx + blockWidth);
+            getMean(bx, by, ex, ey, mean);
+            uint8_t* p = data + (size_t(by) * width_ + bx) * stride;
+            for (int x = bx; x < ex; x++, p += stride) {
+                for (int c = 0; c < numChannels_; c++) p[c] = mean[c];
+            }
+        }
+        for (int y = by + 1; y < ey; y++) {
+            uint8_t* row = data + (size_t(y) * width_ + x0) * stride;
+            ofxGlic::kernels::copyColors(top, row, size_t(x1 - x0), layout_);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGlicEffectKernels.h"
+#include <cstdint>
+#include <vector>
+
+// Summed-area table of an 8-bit frame, for block statistics
+// build() makes one pass over the frame; after that the sum or mean of any
+// rectangle costs four lookups per channel whatever its size, so several
+// block operations on one frame (e.g. pixelate regions with different block
+// sizes) share a single table. Channels are the color channels in the
+// pixels' byte order: one for gray formats, three otherwise; alpha is not
+// summed. The table keeps its memory between frames of the same size: 4
+// bytes per channel per pixel, about 100 MB for a 3840 x 2160 RGB frame.
+// What ofxGlicEffects::pixelateRegions is measured against; it needs only a
+// row of sums per region.
+class IntegralImage {
+public:
+    // False for formats other than GRAY, GRAY_ALPHA, RGB, BGR, RGBA and BGRA
+    bool build(const ofPixels& pixels);
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    int getNumChannels() const { return numChannels_; }
+
+    // Sum of a channel over [x0, x1) x [y0, y1), clipped to the frame
+    // Sums are kept modulo 2^32, which is exact for rectangles of up to
+    // 16843009 pixels (4104 x 4104).
+    uint32_t getSum(int channel, int x0, int y0, int x1, int y1) const;
+
+    // Truncated mean of every channel, as pixelate fills its blocks; zeros
+    // for an empty rectangle
+    void getMean(int x0, int y0, int x1, int y1, uint8_t* mean) const;
+
+    // Fill region of pixels with blockWidth x blockHeight blocks of the built
+    // frame's means. Blocks start at the region's corner and are cut at its
+    // edges; alpha is kept. False unless pixels has the built frame's size
+    // and format.
+    bool pixelate(ofPixels& pixels, const ofRectangle& region, int blockWidth, int blockHeight) const;
+
+    // Memory held by the table
+    size_t getCapacityBytes() const { return sums_.capacity() * sizeof(uint32_t); }
+
+private:
+    uint32_t at(int channel, int x, int y) const {
+        return sums_[(size_t(y) * (width_ + 1) + x) * numChannels_ + channel];
+    }
+
+    int width_ = 0;
+    int height_ = 0;
+    int numChannels_ = 0;
+    ofPixelFormat format_ = OF_PIXELS_UNKNOWN;
+    ofxGlic::kernels::EffectLayout layout_;
+    std::vector<uint32_t> sums_;  // (height + 1) x (width + 1) x channels; row and column 0 are zero
+};
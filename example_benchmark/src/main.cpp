@@ -0,0 +1,7 @@
+#include "ofMain.h"
+#include "ofApp.h"
+
+int main() {
+    ofSetupOpenGL(1024, 768, OF_WINDOW);
+    ofRunApp(new ofApp());
+}
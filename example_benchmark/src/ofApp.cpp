@@ -0,0 +1,1064 @@
+#include "ofApp.h"
+#include "allocationCounter.h"
+#include "integralImage.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    // Average milliseconds per call, after one warm-up call
+    template<typename F>
+    double timeMillis(int iterations, F&& fn) {
+        fn();
+        uint64_t start = ofGetElapsedTimeMicros();
+        for (int i = 0; i < iterations; i++) {
+            fn();
+        }
+        return (ofGetElapsedTimeMicros() - start) / 1000.0 / iterations;
+    }
+
+    // Heap allocations made while running fn
+    template<typename F>
+    size_t countAllocations(F&& fn) {
+        size_t before = getAllocationCount();
+        fn();
+        return getAllocationCount() - before;
+    }
+
+    std::string formatMillis(double ms) {
+        return ofToString(ms, 2) + " ms";
+    }
+
+    std::string formatName(ofPixelFormat format) {
+        switch (format) {
+            case OF_PIXELS_GRAY: return "GRAY";
+            case OF_PIXELS_RGB: return "RGB";
+            case OF_PIXELS_BGR: return "BGR";
+            case OF_PIXELS_RGBA: return "RGBA";
+            case OF_PIXELS_BGRA: return "BGRA";
+            default: return "OTHER";
+        }
+    }
+
+    // Deterministic test frame: gradients with some noise on top
+    ofPixels makeTestPixels(int width, int height, ofPixelFormat format) {
+        ofPixels pixels;
+        pixels.allocate(width, height, format);
+
+        uint32_t state = 0x12345678;
+        unsigned char* data = pixels.getData();
+        size_t channels = pixels.getNumChannels();
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                for (size_t c = 0; c < channels; c++) {
+                    state = state * 1664525u + 1013904223u;
+                    int gradient = (c % 2 == 0) ? (x * 255 / width) : (y * 255 / height);
+                    *data++ = (unsigned char)((gradient + (state >> 28)) & 0xFF);
+                }
+            }
+        }
+        return pixels;
+    }
+
+    // Per-pixel conversion loops the addon used before ofxGlicPixels
+    void legacyToGlicColors(const ofPixels& pixels, std::vector<glic::Color>& colors) {
+        int width = pixels.getWidth();
+        int height = pixels.getHeight();
+        colors.resize(width * height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                ofColor c = pixels.getColor(x, y);
+                colors[y * width + x] = glic::makeColor(c.r, c.g, c.b, c.a);
+            }
+        }
+    }
+
+    void legacyToOfPixels(const std::vector<glic::Color>& colors, int width, int height, ofPixels& pixels) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                glic::Color c = colors[y * width + x];
+                pixels.setColor(x, y, ofColor(glic::getR(c), glic::getG(c), glic::getB(c), glic::getA(c)));
+            }
+        }
+    }
+
+    // One effect through glic colors and back, as ofxGlicEffects did before
+    // its native kernels
+    void applyEffectGlic(ofPixels& pixels, const ofxGlicEffect& effect, std::vector<glic::Color>& colors) {
+        ofxGlic::toGlicColors(pixels, colors);
+        glic::applyEffect(colors, pixels.getWidth(), pixels.getHeight(), effect.toGlic());
+        ofxGlic::toOfPixels(colors.data(), pixels.getWidth(), pixels.getHeight(), pixels);
+    }
+}
+
+void ofApp::setup() {
+    ofSetWindowTitle("ofxGlic Benchmark");
+    ofBackground(30);
+
+    runBenchmarks();
+}
+
+void ofApp::runBenchmarks() {
+    reportLines.clear();
+    report("=== ofxGlic Benchmark ===");
+
+    benchPixelConversion();
+    benchSimdConversion();
+    benchGlitchRoundTrip();
+    benchTiledCodec();
+    benchChannelParallel();
+    benchAsyncCodec();
+    benchCodecPool();
+    benchWorkspace();
+    benchConfigCache();
+    benchColorLut();
+    benchMappedDecode();
+    benchRegionDecode();
+    benchSession();
+    benchStreamMode();
+    benchBatchProcessor();
+    benchSequenceExporter();
+    benchGlitchMulti();
+    benchFrameWriter();
+    benchEffectChain();
+    benchNativeEffects();
+    benchEffectThreads();
+    benchEffectSimd();
+    benchBlockPixelate();
+
+    report("Done. Press R to run again.");
+}
+
+void ofApp::benchPixelConversion() {
+    report("");
+    report("--- ofPixels <-> glic::Color conversion ---");
+
+    const int iterations = 10;
+    const std::vector<std::pair<int, int>> sizes = {{1920, 1080}, {3840, 2160}};
+    const std::vector<ofPixelFormat> formats = {OF_PIXELS_RGBA, OF_PIXELS_BGRA, OF_PIXELS_RGB, OF_PIXELS_GRAY};
+
+    for (const auto& size : sizes) {
+        int width = size.first;
+        int height = size.second;
+
+        for (auto format : formats) {
+            ofPixels source = makeTestPixels(width, height, format);
+            std::vector<glic::Color> legacyColors;
+            std::vector<glic::Color> colors;
+            ofPixels legacyOut = source;
+            ofPixels out = source;
+
+            ofxGlicColorView view;
+            double legacyPack = timeMillis(iterations, [&] { legacyToGlicColors(source, legacyColors); });
+            double pack = timeMillis(iterations, [&] { ofxGlic::toGlicColors(source, colors); });
+            double viewSet = timeMillis(iterations, [&] { view.set(source); });
+            double legacyUnpack = timeMillis(iterations, [&] { legacyToOfPixels(colors, width, height, legacyOut); });
+            double unpack = timeMillis(iterations, [&] { ofxGlic::toOfPixels(colors.data(), width, height, out); });
+
+            report(ofToString(width) + "x" + ofToString(height) + " " + formatName(format));
+            report("  to glic   legacy " + formatMillis(legacyPack) +
+                   " | direct " + formatMillis(pack) +
+                   " | view " + formatMillis(viewSet) + (view.isBorrowed() ? " (zero-copy)" : ""));
+            report("  to ofPixels  legacy " + formatMillis(legacyUnpack) +
+                   " | direct " + formatMillis(unpack));
+        }
+    }
+}
+
+void ofApp::benchSimdConversion() {
+    report("");
+    report("--- SIMD pack/unpack (supported: " + ofxGlic::getSimdLevelName(ofxGlic::getSupportedSimdLevel()) + ") ---");
+
+    const ofxGlic::SimdLevel defaultLevel = ofxGlic::getSimdLevel();
+    const std::vector<ofxGlic::SimdLevel> levels = {
+        ofxGlic::SimdLevel::SCALAR, ofxGlic::SimdLevel::SSE2, ofxGlic::SimdLevel::SSSE3,
+        ofxGlic::SimdLevel::AVX2, ofxGlic::SimdLevel::NEON};
+
+    const int iterations = 20;
+    const std::vector<std::pair<int, int>> sizes = {{640, 480}, {1920, 1080}, {3840, 2160}};
+    for (const auto& size : sizes) {
+        int width = size.first;
+        int height = size.second;
+
+        for (auto format : {OF_PIXELS_RGB, OF_PIXELS_RGBA}) {
+            ofPixels source = makeTestPixels(width, height, format);
+            ofPixels out = source;
+            std::vector<glic::Color> colors;
+
+            std::string line = ofToString(width) + "x" + ofToString(height) + " " + formatName(format);
+            for (auto level : levels) {
+                if (!ofxGlic::setSimdLevel(level)) continue;
+
+                double pack = timeMillis(iterations, [&] { ofxGlic::toGlicColors(source, colors); });
+                double unpack = timeMillis(iterations, [&] { ofxGlic::toOfPixels(colors.data(), width, height, out); });
+                line += " | " + ofxGlic::getSimdLevelName(level) + " " + ofToString(pack, 2) + "/" + ofToString(unpack, 2);
+            }
+            report(line + " ms (to glic / to ofPixels)");
+        }
+    }
+
+    ofxGlic::setSimdLevel(defaultLevel);
+}
+
+void ofApp::benchGlitchRoundTrip() {
+    report("");
+    report("--- Codec round trip (Moderate preset) ---");
+
+    const int iterations = 3;
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+
+    for (auto format : {OF_PIXELS_RGB, OF_PIXELS_RGBA}) {
+        ofPixels source = makeTestPixels(1920, 1080, format);
+        ofImage sourceImage;
+        sourceImage.setFromPixels(source);
+
+        // Two-step ofImage path used by the examples before glitch()
+        double twoStep = timeMillis(iterations, [&] {
+            auto buffer = codec.encodeToBuffer(sourceImage);
+            codec.decodeFromBuffer(buffer);
+        });
+
+        ofPixels out;
+        double glitch = timeMillis(iterations, [&] { codec.glitch(source, out); });
+
+        report("1920x1080 " + formatName(format) + "  encodeToBuffer+decodeFromBuffer " + formatMillis(twoStep) +
+               " | glitch " + formatMillis(glitch));
+    }
+}
+
+void ofApp::benchTiledCodec() {
+    report("");
+    report("--- Tiled codec, 3840x2160 RGBA, 512px tiles (Moderate preset) ---");
+
+    const int iterations = 2;
+    ofPixels source = makeTestPixels(3840, 2160, OF_PIXELS_RGBA);
+
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+
+    std::vector<uint8_t> buffer;
+    ofPixels out;
+    double untiled = timeMillis(iterations, [&] { codec.encodeFrom(source, buffer); });
+    double untiledDecode = timeMillis(iterations, [&] { codec.decodeInto(buffer, out); });
+    report("untiled   encode " + formatMillis(untiled) + " | decode " + formatMillis(untiledDecode));
+
+    codec.setTiling(true, 512);
+
+    // Thread counts 1, 2, 4, ... up to every pool thread plus the caller
+    size_t maxThreads = ofxGlicThreadPool::shared().getNumThreads() + 1;
+    std::vector<size_t> threadCounts;
+    for (size_t n = 1; n < maxThreads; n *= 2) threadCounts.push_back(n);
+    threadCounts.push_back(maxThreads);
+
+    double singleThread = 0;
+
+    for (size_t threads : threadCounts) {
+        codec.setNumThreads(threads);
+
+        double encode = timeMillis(iterations, [&] { codec.encodeFrom(source, buffer); });
+        double decode = timeMillis(iterations, [&] { codec.decodeInto(buffer, out); });
+        if (threads == 1) singleThread = encode + decode;
+
+        report(ofToString(threads) + " thread(s)  encode " + formatMillis(encode) + " | decode " + formatMillis(decode) +
+               " | speedup x" + ofToString(singleThread / (encode + decode), 2));
+    }
+
+    codec.setNumThreads(0);
+}
+
+void ofApp::benchChannelParallel() {
+    report("");
+    report("--- Per-channel glitch, 1920x1080 RGB ---");
+    report("(before: one glic codec | after: one codec per channel in parallel | with color tables)");
+
+    const int iterations = 2;
+    ofPixels source = makeTestPixels(1920, 1080, OF_PIXELS_RGB);
+    ofPixels out;
+
+    for (const std::string name : {"Moderate", "Dreamy"}) {
+        ofxGlicCodec codec;
+        codec.setConfig(ofxGlicPresets::instance().getPreset(name).codecConfig);
+        double single = timeMillis(iterations, [&] { codec.glitch(source, out); });
+        codec.setChannelParallel(true);
+        double parallel = timeMillis(iterations, [&] { codec.glitch(source, out); });
+        codec.setColorLut(true);
+        double tables = timeMillis(iterations, [&] { codec.glitch(source, out); });
+        report(name + "  " + formatMillis(single) + " -> " + formatMillis(parallel) + " | " + formatMillis(tables));
+    }
+}
+
+void ofApp::benchAsyncCodec() {
+    report("");
+    report("--- Async codec, 640x480 RGB (Moderate preset) ---");
+
+    const auto config = ofxGlicPresets::moderate().codecConfig;
+    ofPixels source = makeTestPixels(640, 480, OF_PIXELS_RGB);
+
+    // Futures: a deep enough queue keeps every frame
+    ofxGlicAsyncCodec asyncCodec;
+    const int frames = 20;
+    asyncCodec.setup(2, frames);
+    std::vector<std::future<ofxGlicAsyncResult>> futures;
+    uint64_t start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < frames; i++) {
+        futures.push_back(asyncCodec.submit(source, config));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    double total = (ofGetElapsedTimeMicros() - start) / 1000.0;
+    auto stats = asyncCodec.getStats();
+    report(ofToString(frames) + " frames, 2 workers  total " + formatMillis(total) +
+           " | avg latency " + formatMillis(stats.averageLatencyMillis) +
+           " | max " + formatMillis(stats.maxLatencyMillis));
+
+    // Callbacks with a short queue: submitting never blocks, old frames are dropped
+    asyncCodec.setup(1, 2);
+    int delivered = 0;
+    double longestSubmit = 0;
+    for (int i = 0; i < frames; i++) {
+        uint64_t submitStart = ofGetElapsedTimeMicros();
+        asyncCodec.submit(source, config, [&](const ofxGlicAsyncResult& result) {
+            if (result) delivered++;
+        });
+        longestSubmit = std::max(longestSubmit, (ofGetElapsedTimeMicros() - submitStart) / 1000.0);
+    }
+    auto finished = [&] {
+        auto current = asyncCodec.getStats();
+        return current.completed + current.failed + current.dropped >= (uint64_t)frames;
+    };
+    while (!finished()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    asyncCodec.update();
+    stats = asyncCodec.getStats();
+    report(ofToString(frames) + " frames, queue of 2  delivered " + ofToString(delivered) +
+           " | dropped " + ofToString(stats.dropped) + " | longest submit " + formatMillis(longestSubmit));
+}
+
+void ofApp::benchCodecPool() {
+    report("");
+    report("--- Codec pool, 64 glitches of 256x256 RGBA on the thread pool (Moderate preset) ---");
+
+    const int jobs = 64;
+    const int iterations = 3;
+    ofPixels source = makeTestPixels(256, 256, OF_PIXELS_RGBA);
+    const ofxGlicPreset& preset = ofxGlicPresets::instance().getPreset("Moderate");
+    ofxGlicConfigSnapshot snapshot = ofxGlicPresets::instance().getConfigSnapshot("Moderate");
+    ofxGlicThreadPool& threads = ofxGlicThreadPool::shared();
+    std::vector<ofPixels> outputs(jobs);
+
+    // What encodeImage/decodeImage did before: a new codec for every call
+    double perCall = timeMillis(iterations, [&] {
+        threads.parallelFor(jobs, [&](size_t i) {
+            ofxGlicCodec codec;
+            codec.setConfig(preset.codecConfig);
+            codec.glitch(source, outputs[i]);
+        });
+    });
+
+    ofxGlicCodecPool pool;
+    double pooled = timeMillis(iterations, [&] {
+        threads.parallelFor(jobs, [&](size_t i) {
+            pool.glitch(snapshot, source, outputs[i]);
+        });
+    });
+
+    report("new codec per call " + formatMillis(perCall) + " | pooled " + formatMillis(pooled) +
+           " (" + ofToString(pool.getNumCodecs()) + " codecs)");
+}
+
+void ofApp::benchWorkspace() {
+    report("");
+    report("--- Steady-state allocations per frame, 1280x720 RGB (Moderate preset) ---");
+
+    const int width = 1280;
+    const int height = 720;
+    const auto config = ofxGlicPresets::moderate().codecConfig;
+    ofPixels source = makeTestPixels(width, height, OF_PIXELS_RGB);
+
+    ofxGlicWorkspace workspace;
+    ofxGlicCodec codec;
+    ofxGlicEffects effects;
+    codec.setConfig(config);
+    codec.setWorkspace(&workspace);
+    effects.setWorkspace(&workspace);
+    effects.addScanline(30);
+    effects.addChromatic(2, 0);
+
+    // Allocations glic makes on its own: it returns every bitstream and decoded
+    // frame in a new vector, and some effects copy the frame internally
+    glic::GlicCodec rawCodec;
+    rawCodec.setConfig(config);
+    std::vector<glic::Color> colors;
+    ofxGlic::toGlicColors(source, colors);
+    auto rawFrame = [&] {
+        auto bytes = rawCodec.encodeToBuffer(colors.data(), width, height);
+        auto decoded = rawCodec.decodeFromBuffer(bytes);
+        for (const auto& effect : effects.getEffects()) {
+            glic::applyEffect(decoded.pixels, width, height, effect.toGlic());
+        }
+    };
+    rawFrame();
+    size_t glicAllocations = countAllocations(rawFrame);
+
+    // The same frame through the addon
+    ofPixels out;
+    auto frame = [&] {
+        workspace.reset();
+        codec.glitch(source, out);
+        effects.apply(out);
+    };
+    frame();
+    frame();
+    size_t frameAllocations = countAllocations(frame);
+    size_t addonAllocations = frameAllocations > glicAllocations ? frameAllocations - glicAllocations : 0;
+
+    report("frame total " + ofToString(frameAllocations) + " | inside glic " + ofToString(glicAllocations) +
+           " | ofxGlic " + ofToString(addonAllocations) +
+           " | workspace " + ofToString(workspace.getCapacityBytes() / (1024 * 1024)) + " MB");
+    report(addonAllocations == 0 ? "ofxGlic buffers allocation-free in steady state"
+                                 : "MISMATCH ofxGlic allocates in steady state");
+}
+
+void ofApp::benchConfigCache() {
+    report("");
+    report("--- Config hash and cache ---");
+
+    auto& presets = ofxGlicPresets::instance();
+    std::vector<glic::CodecConfig> configs;
+    for (const auto& name : presets.getPresetNames()) {
+        configs.push_back(presets.getPreset(name).codecConfig);
+    }
+
+    const int iterations = 1000;
+    ofxGlicCodec codec;
+    glic::GlicCodec rawCodec;
+    const glic::CodecConfig& config = configs.front();
+
+    double raw = timeMillis(iterations, [&] { rawCodec.setConfig(config); });
+    double noOp = timeMillis(iterations, [&] { codec.setConfig(config); });
+    report("same config every frame  glic setConfig " + ofToString(raw * 1000.0, 3) + " us" +
+           " | ofxGlicCodec " + ofToString(noOp * 1000.0, 3) + " us");
+
+    // Cycle through every preset twice: only the first pass configures glic codecs
+    uint64_t missesBefore = codec.getConfigCacheMisses();
+    for (const auto& c : configs) codec.setConfig(c);
+    uint64_t firstPass = codec.getConfigCacheMisses() - missesBefore;
+    missesBefore = codec.getConfigCacheMisses();
+    double cycle = timeMillis(10, [&] {
+        for (const auto& c : configs) codec.setConfig(c);
+    });
+    uint64_t laterPasses = codec.getConfigCacheMisses() - missesBefore;
+    report(ofToString(configs.size()) + " presets  new glic codecs: first pass " + ofToString(firstPass) +
+           " | later passes " + ofToString(laterPasses) +
+           " | full cycle " + ofToString(cycle * 1000.0, 2) + " us");
+}
+
+void ofApp::benchColorLut() {
+    report("");
+    report("--- Color space lookup tables, 1920x1080 to and from the space ---");
+    report("(glic per pixel -> table | table build | mismatches with glic in a sample of the RGB cube)");
+
+    const int iterations = 5;
+    std::vector<glic::Color> colors;
+    ofxGlic::toGlicColors(makeTestPixels(1920, 1080, OF_PIXELS_RGBA), colors);
+    std::vector<glic::Color> converted(colors.size());
+
+    // Every 61st RGB triple, with alpha varying too
+    std::vector<glic::Color> sample;
+    for (uint32_t rgb = 0; rgb < (1u << 24); rgb += 61) {
+        sample.push_back(glic::makeColor(uint8_t(rgb >> 16), uint8_t(rgb >> 8), uint8_t(rgb), uint8_t(rgb >> 3)));
+    }
+
+    const std::vector<std::string> names = ofxGlic::getColorSpaceNames();
+    for (size_t i = 0; i < names.size(); i++) {
+        const auto space = glic::ColorSpace(i);
+        double direct = timeMillis(iterations, [&] {
+            for (size_t p = 0; p < colors.size(); p++) converted[p] = glic::toColorspace(colors[p], space);
+            for (size_t p = 0; p < colors.size(); p++) converted[p] = glic::fromColorspace(converted[p], space);
+        });
+
+        uint64_t start = ofGetElapsedTimeMicros();
+        ofxGlicColorLut toSpace(space, ofxGlicColorLut::TO_SPACE);
+        ofxGlicColorLut fromSpace(space, ofxGlicColorLut::FROM_SPACE);
+        double build = (ofGetElapsedTimeMicros() - start) / 1000.0;
+
+        double table = timeMillis(iterations, [&] {
+            toSpace.convert(colors.data(), converted.data(), colors.size());
+            fromSpace.convert(converted.data(), converted.data(), converted.size());
+        });
+
+        size_t mismatches = 0;
+        for (const glic::Color& color : sample) {
+            if (toSpace.convert(color) != glic::toColorspace(color, space)) mismatches++;
+            if (fromSpace.convert(color) != glic::fromColorspace(color, space)) mismatches++;
+        }
+
+        report(names[i] + "  " + formatMillis(direct) + " -> " + formatMillis(table) +
+               " | build " + formatMillis(build) + " | " + ofToString(mismatches) + " of " +
+               ofToString(sample.size() * 2));
+    }
+}
+
+void ofApp::benchMappedDecode() {
+    report("");
+    report("--- File decode, tiled 3840x2160 .glic (Moderate preset) ---");
+
+    const int iterations = 3;
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+    codec.setTiling(true, 512);
+
+    std::vector<uint8_t> stream;
+    codec.encodeFrom(makeTestPixels(3840, 2160, OF_PIXELS_RGBA), stream);
+    std::string path = ofToDataPath("benchmark_tiled.glic", true);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(stream.data()), stream.size());
+    }
+
+    // Read the whole file into an owned vector first, as decodeFromBuffer(vector) needs
+    double vectorTime = timeMillis(iterations, [&] {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        codec.decodeFromBuffer(bytes);
+    });
+
+    double mapTime = timeMillis(iterations, [&] { codec.decode(path); });
+
+    double streamTime = timeMillis(iterations, [&] {
+        std::ifstream file(path, std::ios::binary);
+        codec.decodeFromStream(file);
+    });
+
+    report(ofToString(stream.size() / 1024) + " KB  read+vector " + formatMillis(vectorTime) +
+           " | mmap " + formatMillis(mapTime) + " | stream " + formatMillis(streamTime));
+    ofFile::removeFile(path, false);
+}
+
+void ofApp::benchRegionDecode() {
+    report("");
+    report("--- Region decode, 1920x1080 window of tiled 7680x4320 (Moderate preset) ---");
+
+    const int iterations = 2;
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+    codec.setTiling(true, 512);
+
+    std::vector<uint8_t> stream;
+    codec.encodeFrom(makeTestPixels(7680, 4320, OF_PIXELS_RGBA), stream);
+
+    // Deliberately not aligned to the tile grid
+    ofRectangle window(3000, 1700, 1920, 1080);
+
+    ofPixels full;
+    double fullTime = timeMillis(iterations, [&] { codec.decodeInto(stream, full); });
+    ofPixels region;
+    double regionTime = timeMillis(iterations, [&] {
+        codec.decodeRegionInto(stream.data(), stream.size(), window, region);
+    });
+
+    report("full " + formatMillis(fullTime) + " | region " + formatMillis(regionTime) +
+           " | speedup x" + ofToString(fullTime / regionTime, 2));
+}
+
+void ofApp::benchSession() {
+    report("");
+    report("--- Session, 3840x2160 RGB still (Moderate preset) ---");
+
+    ofPixels source = makeTestPixels(3840, 2160, OF_PIXELS_RGB);
+    glic::CodecConfig config = ofxGlicPresets::moderate().codecConfig;
+    glic::CodecConfig changed = config;
+    for (auto& channel : changed.channels) channel.quantizationValue += 10;
+    std::vector<ofxGlicEffect> effects = {ofxGlicEffect::scanline(40)};
+    std::vector<ofxGlicEffect> otherEffects = {ofxGlicEffect::scanline(60)};
+
+    // What a slider change costs without a session: the whole pipeline
+    ofxGlicCodec codec;
+    ofxGlicEffects effectsProcessor;
+    effectsProcessor.setEffects(effects);
+    ofPixels direct;
+    double fullTime = timeMillis(2, [&] {
+        codec.setConfig(changed);
+        codec.glitch(source, direct);
+        effectsProcessor.apply(direct);
+    });
+
+    ofxGlicSession session;
+    session.setSource(source);
+    session.setConfig(config);
+    session.setEffects(effects);
+    session.update();
+
+    // Alternate between two values of one parameter, as when dragging a slider
+    bool flip = false;
+    double effectsTime = timeMillis(4, [&] {
+        session.setEffects((flip = !flip) ? otherEffects : effects);
+        session.update();
+    });
+    session.setEffects(effects);
+    uint64_t encodesBefore = session.getNumEncodes();
+    double configTime = timeMillis(4, [&] {
+        session.setConfig((flip = !flip) ? changed : config);
+        session.update();
+    });
+    uint64_t encodes = session.getNumEncodes() - encodesBefore;
+
+    report("full pipeline " + formatMillis(fullTime) + " | effects change " + formatMillis(effectsTime) +
+           " | config change (cached) " + formatMillis(configTime) + " | encodes " + ofToString(encodes));
+}
+
+void ofApp::benchStreamMode() {
+    report("");
+    report("--- Stream mode, 1280x720 RGB frames, 128px tiles (Moderate preset) ---");
+
+    // A static background with a small square moving across it
+    const int numFrames = 10;
+    std::vector<ofPixels> frames(numFrames);
+    for (int i = 0; i < numFrames; i++) {
+        frames[i] = makeTestPixels(1280, 720, OF_PIXELS_RGB);
+        for (int y = 300; y < 400; y++) {
+            for (int x = 100 + i * 40; x < 200 + i * 40; x++) {
+                frames[i].setColor(x, y, ofColor(255, 0, 0));
+            }
+        }
+    }
+
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+    codec.setTiling(true, 128);
+
+    std::vector<ofPixels> plain(numFrames);
+    int index = 0;
+    double plainTime = timeMillis(numFrames - 1, [&] {
+        codec.glitch(frames[index], plain[index]);
+        index++;
+    });
+
+    codec.setStreamMode(true, 0.0f);
+    ofPixels out;
+    int reused = 0, encoded = 0;
+    index = 0;
+    double streamTime = timeMillis(numFrames - 1, [&] {
+        codec.glitch(frames[index], out);
+        if (index > 0) {
+            reused += codec.getStreamTilesReused();
+            encoded += codec.getStreamTilesEncoded();
+        }
+        index++;
+    });
+
+    report("per frame  plain " + formatMillis(plainTime) + " | stream " + formatMillis(streamTime) +
+           " | tiles reused " + ofToString(reused) + " of " + ofToString(reused + encoded));
+}
+
+void ofApp::benchBatchProcessor() {
+    report("");
+    report("--- Batch processor, 32 images of 512x512 RGB in memory (VHS preset) ---");
+
+    const int numImages = 32;
+    ofxGlicPreset preset = ofxGlicPresets::vhs();
+    ofPixels source = makeTestPixels(512, 512, OF_PIXELS_RGB);
+    std::vector<ofxGlicBatchJob> jobs(numImages);
+    for (auto& job : jobs) job.pixels = source;
+
+    std::string line;
+    size_t maxThreads = ofxGlicThreadPool::shared().getNumThreads();
+    for (size_t threads = 1; threads <= maxThreads; threads++) {
+        ofxGlicBatchProcessor batch;
+        batch.setMaxConcurrency(threads);
+        uint64_t start = ofGetElapsedTimeMicros();
+        batch.start(jobs, preset);
+        batch.wait();
+        double time = (ofGetElapsedTimeMicros() - start) / 1000.0;
+        line += (line.empty() ? "" : " | ") + ofToString(threads) + " at once " + formatMillis(time);
+    }
+    report(line);
+
+    // Cancelling skips the jobs that have not started
+    ofxGlicBatchProcessor batch;
+    batch.setMaxConcurrency(1);
+    batch.start(jobs, preset);
+    batch.cancel();
+    batch.wait();
+    size_t cancelled = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (batch.getJobState(i) == ofxGlicBatchJob::State::Cancelled) cancelled++;
+    }
+    report("cancelled right after start: " + ofToString(cancelled) + " of " + ofToString(numImages) +
+           " skipped | steals so far " + ofToString(ofxGlicThreadPool::shared().getNumSteals()));
+}
+
+void ofApp::benchSequenceExporter() {
+    report("");
+    report("--- Sequence exporter, 48 frames of 640x360 RGB (VHS preset) ---");
+
+    const int numFrames = 48;
+    ofxGlicPreset preset = ofxGlicPresets::vhs();
+    ofPixels frame = makeTestPixels(640, 360, OF_PIXELS_RGB);
+
+    ofxGlicExportSettings settings;
+    settings.folder = (std::filesystem::temp_directory_path() / "ofxGlicBenchExport").string();
+    std::filesystem::remove_all(settings.folder);
+    std::filesystem::create_directories(settings.folder);
+
+    // Serial baseline: glitch and save one frame after the other
+    ofxGlicCodec codec;
+    codec.setConfig(preset.codecConfig);
+    ofPixels result;
+    uint64_t start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < numFrames; i++) {
+        codec.glitch(frame, result);
+        for (const auto& effect : preset.effects) {
+            ofxGlicEffects::applyEffect(result, effect);
+        }
+        ofSaveImage(result, ofxGlicSequenceExporter::getFramePath(settings, i));
+    }
+    double serialTime = (ofGetElapsedTimeMicros() - start) / 1000.0;
+    std::filesystem::remove_all(settings.folder);
+
+    ofxGlicSequenceExporter exporter;
+    start = ofGetElapsedTimeMicros();
+    exporter.start(settings, preset);
+    for (int i = 0; i < numFrames; i++) {
+        exporter.push(frame, i);
+    }
+    exporter.close();
+    exporter.wait();
+    double pipelineTime = (ofGetElapsedTimeMicros() - start) / 1000.0;
+    ofxGlicExportStats stats = exporter.getStats();
+
+    report("total  serial " + formatMillis(serialTime) + " | pipelined " + formatMillis(pipelineTime));
+    report("stages glitch " + formatMillis(stats.processMillisPerFrame) + "/frame | write " +
+           formatMillis(stats.writeMillisPerFrame) + "/frame | source waited " + formatMillis(stats.pushWaitMillis));
+    std::filesystem::remove_all(settings.folder);
+}
+
+void ofApp::benchGlitchMulti() {
+    report("");
+    report("--- Multi-preset glitch, 1280x720 RGB frame with every built-in preset ---");
+
+    ofPixels source = makeTestPixels(1280, 720, OF_PIXELS_RGB);
+    std::vector<ofxGlicPreset> presets;
+    for (const auto& name : ofxGlicPresets::instance().getPresetNames()) {
+        presets.push_back(ofxGlicPresets::instance().getPreset(name));
+    }
+    // Same codec config, different effects: shares one encode with its original
+    ofxGlicPreset scanlined = presets.front();
+    scanlined.name += " Scanlined";
+    scanlined.effects.push_back(ofxGlicEffect::scanline(40));
+    presets.push_back(scanlined);
+
+    ofxGlicCodec codec;
+    std::vector<ofPixels> expected(presets.size());
+    double separateTime = timeMillis(3, [&] {
+        for (size_t i = 0; i < presets.size(); i++) {
+            codec.setConfig(presets[i].codecConfig);
+            codec.glitch(source, expected[i]);
+            for (const auto& effect : presets[i].effects) {
+                ofxGlicEffects::applyEffect(expected[i], effect, codec.getWorkspace());
+            }
+        }
+    });
+
+    ofxGlicCodec multiCodec;
+    std::vector<ofPixels> outs;
+    double multiTime = timeMillis(3, [&] { multiCodec.glitchMulti(source, presets, outs); });
+
+    report(ofToString(presets.size()) + " presets  one at a time " + formatMillis(separateTime) +
+           " | glitchMulti " + formatMillis(multiTime));
+}
+
+void ofApp::benchFrameWriter() {
+    report("");
+    report("--- Frame writer, 60 frames of 1280x720 RGB ---");
+
+    const int numFrames = 60;
+    const int width = 1280, height = 720;
+    ofPixels frame = makeTestPixels(width, height, OF_PIXELS_RGB);
+    std::filesystem::path folder = std::filesystem::temp_directory_path() / "ofxGlicBenchWriter";
+    std::filesystem::remove_all(folder);
+    std::filesystem::create_directories(folder);
+
+    // One image file per frame, as example_video used to write
+    uint64_t start = ofGetElapsedTimeMicros();
+    for (int i = 0; i < numFrames; i++) {
+        ofSaveImage(frame, (folder / ("frame_" + ofToString(i, 5, '0') + ".png")).string());
+    }
+    double imageTime = (ofGetElapsedTimeMicros() - start) / 1000.0;
+
+    std::string line = "images " + formatMillis(imageTime);
+    struct Variant {
+        const char* name;
+        ofxGlicFrameFormat format;
+        bool async;
+        int syncInterval;
+    };
+    const Variant variants[] = {
+        {"y4m", ofxGlicFrameFormat::Y4M, false, 0},
+        {"y4m 4:2:0", ofxGlicFrameFormat::Y4M420, false, 0},
+        {"rgba", ofxGlicFrameFormat::RGBA, false, 0},
+        {"y4m async", ofxGlicFrameFormat::Y4M, true, 0},
+        {"y4m sync/30", ofxGlicFrameFormat::Y4M, false, 30},
+    };
+    for (const auto& variant : variants) {
+        ofxGlicFrameWriterSettings settings;
+        settings.format = variant.format;
+        settings.async = variant.async;
+        settings.syncInterval = variant.syncInterval;
+        std::filesystem::path path = folder / ("frames." + ofxGlicFrameWriter::getExtension(variant.format));
+
+        ofxGlicFrameWriter writer;
+        start = ofGetElapsedTimeMicros();
+        bool ok = writer.open(path.string(), width, height, settings);
+        for (int i = 0; ok && i < numFrames; i++) {
+            ok = writer.write(frame);
+        }
+        writer.close();
+        double time = (ofGetElapsedTimeMicros() - start) / 1000.0;
+        line += " | " + std::string(variant.name) + " " + formatMillis(time);
+    }
+    report(line);
+
+    std::filesystem::remove_all(folder);
+}
+
+void ofApp::benchEffectChain() {
+    report("");
+    report("--- Effect chains, 1280x720 RGB, every built-in preset ---");
+    report("(before: each effect through glic colors | after: applyEffects with fused pointwise effects)");
+
+    ofPixels source = makeTestPixels(1280, 720, OF_PIXELS_RGB);
+    ofxGlicWorkspace workspace;
+    std::vector<glic::Color> colors;
+    for (const auto& name : ofxGlicPresets::instance().getPresetNames()) {
+        const ofxGlicPreset& preset = ofxGlicPresets::instance().getPreset(name);
+        if (preset.effects.empty()) continue;
+
+        ofPixels before = source;
+        double beforeTime = timeMillis(5, [&] {
+            before = source;
+            for (const auto& effect : preset.effects) {
+                applyEffectGlic(before, effect, colors);
+            }
+        });
+
+        ofPixels after = source;
+        double afterTime = timeMillis(5, [&] {
+            after = source;
+            ofxGlicEffects::applyEffects(after, preset.effects, workspace);
+        });
+
+        size_t passes = ofxGlicEffectChain::get(preset.effects)->getNumPasses();
+        report(name + "  " + ofToString(preset.effects.size()) + " effects in " + ofToString(passes) + " passes  " +
+               formatMillis(beforeTime) + " -> " + formatMillis(afterTime));
+    }
+}
+
+void ofApp::benchNativeEffects() {
+    report("");
+    report("--- Native effects, 1280x720 ---");
+    report("(before: through glic colors | after: in place on ofPixels)");
+
+    std::vector<ofxGlicEffect> effects = {
+        ofxGlicEffect::pixelate(8), ofxGlicEffect::scanline(50), ofxGlicEffect::chromatic(3, 1),
+        ofxGlicEffect::dither(50), ofxGlicEffect::posterize(4), ofxGlicEffect::glitchShift(8, 12345)};
+    std::vector<ofPixelFormat> formats = {OF_PIXELS_RGB, OF_PIXELS_RGBA, OF_PIXELS_BGRA, OF_PIXELS_GRAY};
+    ofxGlicWorkspace workspace;
+    std::vector<glic::Color> colors;
+
+    for (const auto& effect : effects) {
+        std::string line = ofxGlicEffects::getEffectName(effect.type) + " ";
+        for (auto format : formats) {
+            ofPixels source = makeTestPixels(1280, 720, format);
+            ofPixels before = source;
+            ofPixels after = source;
+            double beforeTime = timeMillis(5, [&] {
+                before = source;
+                applyEffectGlic(before, effect, colors);
+            });
+            double afterTime = timeMillis(5, [&] {
+                after = source;
+                ofxGlicEffects::applyEffect(after, effect, workspace);
+            });
+            line += " | " + formatName(format) + " " + formatMillis(beforeTime) + " -> " + formatMillis(afterTime);
+        }
+        report(line);
+    }
+
+    // Float kernels, without rounding to 8 bits
+    ofFloatPixels hdr;
+    hdr.allocate(1280, 720, OF_PIXELS_RGBA);
+    ofPixels source = makeTestPixels(1280, 720, OF_PIXELS_RGBA);
+    for (size_t i = 0; i < hdr.size(); i++) {
+        hdr[i] = source[i] / 255.0f;
+    }
+    for (const auto& name : {std::string("VHS"), std::string("Retro")}) {
+        const std::vector<ofxGlicEffect>& chain = ofxGlicPresets::instance().getPreset(name).effects;
+        ofFloatPixels pixels;
+        double time = timeMillis(5, [&] {
+            pixels = hdr;
+            ofxGlicEffects::applyEffects(pixels, chain, workspace);
+        });
+        report(name + " on RGBA float  " + formatMillis(time));
+    }
+}
+
+void ofApp::benchEffectThreads() {
+    report("");
+    report("--- Row-parallel effects, 3840x2160 RGB ---");
+    report("(before: 1 thread | after: all threads)");
+
+    ofPixels source = makeTestPixels(3840, 2160, OF_PIXELS_RGB);
+    ofxGlicWorkspace workspace;
+    std::vector<std::pair<std::string, std::vector<ofxGlicEffect>>> chains = {
+        {"VHS", ofxGlicPresets::instance().getPreset("VHS").effects},
+        {"Retro", ofxGlicPresets::instance().getPreset("Retro").effects},
+        {"pixelate(7)", {ofxGlicEffect::pixelate(7)}},
+        {"chromatic(3, 5)", {ofxGlicEffect::chromatic(3, 5)}},
+        {"chromatic(-2, -9)", {ofxGlicEffect::chromatic(-2, -9)}},
+        {"chromatic(4, 150)", {ofxGlicEffect::chromatic(4, 150)}},  // Halo too large for many bands
+        {"glitchShift(5)", {ofxGlicEffect::glitchShift(5, 777)}}};
+
+    for (const auto& chain : chains) {
+        ofPixels single = source;
+        double singleTime = timeMillis(3, [&] {
+            single = source;
+            ofxGlicEffects::applyEffects(single, chain.second, workspace, 1);
+        });
+        ofPixels parallel = source;
+        double parallelTime = timeMillis(3, [&] {
+            parallel = source;
+            ofxGlicEffects::applyEffects(parallel, chain.second, workspace, 0);
+        });
+        report(chain.first + "  " + formatMillis(singleTime) + " -> " + formatMillis(parallelTime));
+    }
+
+}
+
+void ofApp::benchEffectSimd() {
+    report("");
+    report("--- SIMD pointwise effects, 1920x1080 (supported: " +
+           ofxGlic::getSimdLevelName(ofxGlic::getSupportedSimdLevel()) + ") ---");
+
+    const ofxGlic::SimdLevel defaultLevel = ofxGlic::getSimdLevel();
+    const std::vector<ofxGlic::SimdLevel> levels = {
+        ofxGlic::SimdLevel::SCALAR, ofxGlic::SimdLevel::SSE2, ofxGlic::SimdLevel::SSSE3,
+        ofxGlic::SimdLevel::AVX2, ofxGlic::SimdLevel::NEON};
+    const std::vector<std::pair<std::string, std::vector<ofxGlicEffect>>> chains = {
+        {"posterize(4)", {ofxGlicEffect::posterize(4)}},
+        {"scanline(40)", {ofxGlicEffect::scanline(40)}},
+        {"dither(40)", {ofxGlicEffect::dither(40)}},
+        {"scanline(30) + dither(40)", {ofxGlicEffect::scanline(30), ofxGlicEffect::dither(40)}},
+        {"Retro", ofxGlicPresets::instance().getPreset("Retro").effects}};
+    ofxGlicWorkspace workspace;
+
+    for (auto format : {OF_PIXELS_RGB, OF_PIXELS_RGBA}) {
+        ofPixels source = makeTestPixels(1920, 1080, format);
+        for (const auto& chain : chains) {
+            std::string line = chain.first + " " + formatName(format);
+            for (auto level : levels) {
+                if (!ofxGlic::setSimdLevel(level)) continue;
+                ofPixels pixels = source;
+                double time = timeMillis(10, [&] { ofxGlicEffects::applyEffects(pixels, chain.second, workspace); });
+                line += " | " + ofxGlic::getSimdLevelName(level) + " " + formatMillis(time);
+            }
+            report(line);
+        }
+    }
+
+    ofxGlic::setSimdLevel(defaultLevel);
+}
+
+void ofApp::benchBlockPixelate() {
+    report("");
+    report("--- Block-sum pixelate, 1920x1080 ---");
+    report("(glic colors | native summed-area rows)");
+
+    ofxGlicWorkspace workspace;
+    std::vector<glic::Color> colors;
+    for (int blockSize : {2, 4, 8, 16, 64}) {
+        ofxGlicEffect effect = ofxGlicEffect::pixelate(blockSize);
+        std::string line = "pixelate(" + ofToString(blockSize) + ")";
+        for (auto format : {OF_PIXELS_RGB, OF_PIXELS_RGBA, OF_PIXELS_GRAY}) {
+            ofPixels source = makeTestPixels(1920, 1080, format);
+            ofPixels before = source;
+            ofPixels after = source;
+            double beforeTime = timeMillis(5, [&] {
+                before = source;
+                applyEffectGlic(before, effect, colors);
+            });
+            double afterTime = timeMillis(5, [&] {
+                after = source;
+                ofxGlicEffects::applyEffect(after, effect, workspace);
+            });
+            line += " | " + formatName(format) + " " + formatMillis(beforeTime) + " -> " + formatMillis(afterTime);
+        }
+        report(line);
+    }
+
+    // Non-square blocks have no glic counterpart
+    ofPixels source = makeTestPixels(1920, 1080, OF_PIXELS_RGBA);
+    IntegralImage integral;
+    double buildTime = timeMillis(5, [&] { integral.build(source); });
+    for (const auto& block : std::vector<std::pair<int, int>>{{16, 4}, {3, 24}}) {
+        ofxGlicEffect effect = ofxGlicEffect::pixelate(block.first, block.second);
+        ofPixels native = source;
+        double nativeTime = timeMillis(5, [&] {
+            native = source;
+            ofxGlicEffects::applyEffect(native, effect, workspace);
+        });
+        report("pixelate(" + ofToString(block.first) + ", " + ofToString(block.second) + ") RGBA  " +
+               formatMillis(nativeTime));
+    }
+
+    std::vector<ofxGlicPixelateRegion> regions(3);
+    regions[0].area.set(0, 0, 1920, 1080);
+    regions[0].blockWidth = regions[0].blockHeight = 32;
+    regions[1].area.set(400, 200, 640, 480);
+    regions[1].blockWidth = regions[1].blockHeight = 8;
+    regions[2].area.set(1200, 500, 300, 300);
+    regions[2].blockWidth = 4;
+    regions[2].blockHeight = 12;
+    ofPixels pixels = source;
+    double regionsTime = timeMillis(5, [&] {
+        pixels = source;
+        ofxGlicEffects::pixelateRegions(pixels, regions, workspace);
+    });
+
+    // Regions apply in order, so the integral image is rebuilt after each
+    ofPixels expected = source;
+    double tableTime = timeMillis(5, [&] {
+        expected = source;
+        for (const auto& region : regions) {
+            integral.build(expected);
+            integral.pixelate(expected, region.area, region.blockWidth, region.blockHeight);
+        }
+    });
+    report("3 regions  integral image per region " + formatMillis(tableTime) + " -> row sums " +
+           formatMillis(regionsTime));
+    report("integral image build " + formatMillis(buildTime) + " | table " +
+           ofToString(integral.getCapacityBytes() / (1024 * 1024)) + " MB");
+}
+
+void ofApp::report(const std::string& line) {
+    std::cout << line << std::endl;
+    reportLines.push_back(line);
+}
+
+void ofApp::draw() {
+    ofSetColor(255);
+
+    float y = 20;
+    for (const auto& line : reportLines) {
+        ofDrawBitmapString(line, 20, y);
+        y += 14;
+    }
+}
+
+void ofApp::keyPressed(int key) {
+    if (key == 'r' || key == 'R') {
+        runBenchmarks();
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGlic.h"
+
+// Micro benchmarks for the ofxGlic hot paths
+// Results are printed to the console and shown in the window.
+class ofApp : public ofBaseApp {
+public:
+    void setup() override;
+    void draw() override;
+    void keyPressed(int key) override;
+
+private:
+    void runBenchmarks();
+    void benchPixelConversion();
+    void benchSimdConversion();
+    void benchGlitchRoundTrip();
+    void benchTiledCodec();
+    void benchChannelParallel();
+    void benchAsyncCodec();
+    void benchCodecPool();
+    void benchWorkspace();
+    void benchConfigCache();
+    void benchColorLut();
+    void benchMappedDecode();
+    void benchRegionDecode();
+    void benchSession();
+    void benchStreamMode();
+    void benchBatchProcessor();
+    void benchSequenceExporter();
+    void benchGlitchMulti();
+    void benchFrameWriter();
+    void benchEffectChain();
+    void benchNativeEffects();
+    void benchEffectThreads();
+    void benchEffectSimd();
+    void benchBlockPixelate();
+
+    void report(const std::string& line);
+
+    std::vector<std::string> reportLines;
+};
@@ -20,6 +20,12 @@ void ofApp::setup() {
     gui.add(autoMode.setup("Auto Process", false));
     gui.add(skipFrames.setup("Frame Skip", 5, 1, 30));
 
+    // One worker, at most two frames waiting
+    asyncCodec.setup(1, 2);
+    // Reuse the previous result while the camera sees no change; untiled,
+    // so the frames look as they do without stream mode
+    asyncCodec.setStreamMode(true, 2.0f);
+
     // Setup default effects
     effects.addScanline(30);
     effects.addChromatic(2, 0);
@@ -33,6 +39,9 @@ void ofApp::setup() {
 void ofApp::update() {
     camera.update();
 
+    // Deliver finished frames
+    asyncCodec.update();
+
     if (camera.isFrameNew()) {
         frameCounter++;
 
@@ -44,14 +53,6 @@ void ofApp::update() {
 }
 
 void ofApp::processFrame() {
-    if (isProcessing) return;
-
-    isProcessing = true;
-    uint64_t startTime = ofGetElapsedTimeMillis();
-
-    // Capture current frame
-    capturedFrame.setFromPixels(camera.getPixels());
-
     // Get current preset
     std::string presetName = presetNames[presetIndex];
     auto preset = ofxGlicPresets::instance().getPreset(presetName);
@@ -61,29 +62,22 @@ void ofApp::processFrame() {
     for (int i = 0; i < 3; i++) {
         config.channels[i].quantizationValue = quantization;
     }
-    codec.setConfig(config);
-
-    // Process (encode to memory buffer, then decode - skipping file I/O for speed)
-    auto buffer = codec.encodeToBuffer(capturedFrame);
-    if (!buffer.empty()) {
-        auto result = codec.decodeFromBuffer(buffer);
-        if (result.success) {
-            processedFrame = result.image;
-
-            // Apply effects if enabled
-            if (enableEffects) {
-                // First apply preset effects
-                for (const auto& e : preset.effects) {
-                    ofxGlicEffects::applyEffect(processedFrame, e);
-                }
-                // Then apply custom effects
-                effects.apply(processedFrame);
-            }
-        }
+
+    // Preset effects first, then the custom ones
+    std::vector<ofxGlicEffect> frameEffects;
+    if (enableEffects) {
+        frameEffects = preset.effects;
+        frameEffects.insert(frameEffects.end(), effects.getEffects().begin(), effects.getEffects().end());
     }
 
-    lastProcessTime = ofGetElapsedTimeMillis() - startTime;
-    isProcessing = false;
+    // Encode, decode and effects run on a worker thread; when frames come in
+    // faster than they are processed the oldest waiting one is dropped
+    asyncCodec.submit(camera.getPixels(), config, [this](const ofxGlicAsyncResult& result) {
+        if (result) {
+            processedFrame.setFromPixels(result.pixels);
+            lastProcessTime = result.latencyMillis;
+        }
+    }, frameEffects);
 }
 
 void ofApp::draw() {
@@ -111,7 +105,9 @@ void ofApp::draw() {
     // Info
     ofSetColor(255);
     std::string info = "Preset: " + presetNames[presetIndex];
-    info += " | Process time: " + ofToString(lastProcessTime) + "ms";
+    auto stats = asyncCodec.getStats();
+    info += " | Latency: " + ofToString(lastProcessTime, 1) + "ms";
+    info += " | Queue: " + ofToString(stats.queueDepth) + " | Dropped: " + ofToString(stats.dropped);
     info += " | FPS: " + ofToString((int)ofGetFrameRate());
     if (autoMode) {
         info += " | AUTO MODE";
@@ -150,5 +146,6 @@ void ofApp::keyPressed(int key) {
 }
 
 void ofApp::exit() {
+    asyncCodec.close();
     camera.close();
 }
@@ -16,13 +16,11 @@ private:
     void processFrame();
 
     ofVideoGrabber camera;
-    ofxGlicCodec codec;
+    ofxGlicAsyncCodec asyncCodec;
     ofxGlicEffects effects;
 
-    ofImage capturedFrame;
     ofImage processedFrame;
 
-    bool isProcessing = false;
     bool autoProcess = false;
     int frameSkip = 5;
     int frameCounter = 0;
@@ -36,5 +34,5 @@ private:
     ofxIntSlider skipFrames;
 
     std::vector<std::string> presetNames;
-    uint64_t lastProcessTime = 0;
+    double lastProcessTime = 0;
 };
@@ -23,11 +23,13 @@ void ofApp::setup() {
     gui.add(presetBlocky.setup("Blocky", false));
     gui.add(presetDreamy.setup("Dreamy", false));
     gui.add(presetRetro.setup("Retro", false));
+    gui.add(streamToggle.setup("Y4M Stream", false));
 
     std::cout << "=== ofxGlic Video Processor ===" << std::endl;
     std::cout << "Drag and drop a video file to load" << std::endl;
     std::cout << "Select presets and press ENTER to export" << std::endl;
     std::cout << "Output: bin/data/output/<preset_name>/frame_XXXXX.png" << std::endl;
+    std::cout << "    or: bin/data/output/<preset_name>/frames.y4m with Y4M Stream on (much faster)" << std::endl;
     std::cout << std::endl;
     std::cout << "Tip: Convert image sequence to video with ffmpeg:" << std::endl;
     std::cout << "  ffmpeg -framerate 30 -i frame_%05d.png -c:v libx264 output.mp4" << std::endl;
@@ -90,131 +92,149 @@ void ofApp::startExport() {
 
     int framesPerPreset = (endFrame - startFrame) / frameStep + 1;
 
-    // Create export jobs
-    exportJobs.clear();
+    // Every frame is read once and glitched with all selected presets;
+    // output/<preset>/frame_XXXXX.png
+    exportPresets.clear();
     for (const auto& presetName : selectedPresets) {
-        ExportJob job;
-        job.presetName = presetName;
-        job.outputFolder = ofToDataPath("output/" + presetName);
-        job.currentFrame = startFrame;
-        job.totalFrames = framesPerPreset;
-        job.completed = false;
-
-        // Create output folder
-        ofDirectory dir(job.outputFolder);
-        if (!dir.exists()) {
-            dir.create(true);
-        }
+        exportPresets.push_back(ofxGlicPresets::instance().getPreset(presetName));
+    }
+    exportSettings = ofxGlicExportSettings();
+    exportSettings.folder = ofToDataPath("output");
+    exportSettings.filePattern = "frame_%05d.png";
+    exportSettings.streamOutput = streamToggle;
+    if (video.getDuration() > 0) {
+        // Frame rate of the exported frames in 1/1000 steps
+        float fps = video.getTotalNumFrames() / video.getDuration() / frameStep;
+        exportSettings.stream.frameRateNum = std::max(1, (int)std::round(fps * 1000));
+        exportSettings.stream.frameRateDen = 1000;
+    }
 
-        exportJobs.push_back(job);
+    // Image frames already on disk from an interrupted export are skipped;
+    // a stream always starts over
+    nextExportFrame = exportSettings.streamOutput
+                          ? 0
+                          : ofxGlicSequenceExporter::findResumeFrame(exportSettings, exportPresets, framesPerPreset);
+    totalExportFrames = framesPerPreset;
+    if (nextExportFrame >= totalExportFrames) {
+        std::cout << "Already exported, delete the output folders to export again" << std::endl;
+        return;
+    }
+    if (!exporter.start(exportSettings, exportPresets)) {
+        std::cout << "Failed to start export: " << exporter.getStats().lastError << std::endl;
+        return;
     }
 
-    currentJobIndex = 0;
-    exportedFrames = 0;
-    totalExportFrames = framesPerPreset * selectedPresets.size();
+    resumeFrame = nextExportFrame;
+    exportedFrames = resumeFrame;
     exportStartTime = ofGetElapsedTimef();
+    lastReportTime = 0;
+    lastPreviewTime = 0;
+    pendingFrame.clear();
     isExporting = true;
 
     std::cout << std::endl;
     std::cout << "=== Starting Export ===" << std::endl;
     std::cout << "Presets: " << selectedPresets.size() << std::endl;
     std::cout << "Frames per preset: " << framesPerPreset << std::endl;
-    std::cout << "Total frames: " << totalExportFrames << std::endl;
+    if (resumeFrame > 0) {
+        std::cout << "Resuming at frame: " << resumeFrame << std::endl;
+    }
     std::cout << "Frame range: " << startFrame << " - " << endFrame << " (step: " << frameStep << ")" << std::endl;
     std::cout << std::endl;
-
-    // Set video to start frame
-    video.setFrame(startFrame);
-    video.update();
 }
 
 void ofApp::processNextFrame() {
-    if (!isExporting || currentJobIndex >= exportJobs.size()) {
+    if (!isExporting) {
         return;
     }
 
-    auto& job = exportJobs[currentJobIndex];
-
-    // Check if current job is complete
-    if (job.currentFrame > endFrame) {
-        job.completed = true;
-        std::cout << "Completed preset: " << job.presetName << std::endl;
-        nextPreset();
-        return;
-    }
+    // Feed frames until the pipeline is full; decoding stays on the main
+    // thread, glitching and saving run on the exporter's threads
+    while (nextExportFrame < totalExportFrames) {
+        if (!pendingFrame.isAllocated()) {
+            video.setFrame(startFrame + nextExportFrame * frameStep);
+            video.update();
+            video.getPixels().cropTo(pendingFrame, 0, 0, video.getWidth(), video.getHeight());
+        }
+        if (!exporter.tryPush(pendingFrame, nextExportFrame)) {
+            break;
+        }
 
-    // Set video frame
-    video.setFrame(job.currentFrame);
-    video.update();
-
-    // Capture frame
-    ofPixels pixels;
-    video.getPixels().cropTo(pixels, 0, 0, video.getWidth(), video.getHeight());
-    currentFrame.setFromPixels(pixels);
-
-    // Get preset and configure codec
-    auto preset = ofxGlicPresets::instance().getPreset(job.presetName);
-    codec.setConfig(preset.codecConfig);
-
-    // Process frame
-    auto buffer = codec.encodeToBuffer(currentFrame);
-    if (!buffer.empty()) {
-        auto result = codec.decodeFromBuffer(buffer);
-        if (result.success) {
-            processedFrame = result.image;
-
-            // Apply preset effects
-            for (const auto& e : preset.effects) {
-                ofxGlicEffects::applyEffect(processedFrame, e);
+        // Occasional preview of the first preset so the window shows what is being exported
+        float now = ofGetElapsedTimef();
+        if (now - lastPreviewTime > 1.0f) {
+            lastPreviewTime = now;
+            currentFrame.setFromPixels(pendingFrame);
+            codec.setConfig(exportPresets.front().codecConfig);
+            if (codec.glitch(pendingFrame, processedPixels)) {
+                ofxGlicEffects::applyEffects(processedPixels, exportPresets.front().effects, codec.getWorkspace());
+                processedFrame.setFromPixels(processedPixels);
             }
+        }
 
-            // Save frame
-            int frameNum = (job.currentFrame - startFrame) / frameStep;
-            std::string filename = job.outputFolder + "/frame_" + ofToString(frameNum, 5, '0') + ".png";
-            processedFrame.save(filename);
+        pendingFrame.clear();
+        nextExportFrame++;
+    }
 
-            exportedFrames++;
-        }
+    if (nextExportFrame >= totalExportFrames) {
+        exporter.close();
     }
 
-    // Move to next frame
-    job.currentFrame += frameStep;
+    ofxGlicExportStats stats = exporter.getStats();
+    exportedFrames = resumeFrame + (int)stats.written;
 
     // Progress update
-    if (exportedFrames % 10 == 0) {
+    float elapsed = ofGetElapsedTimef() - exportStartTime;
+    if (elapsed - lastReportTime > 2.0f && stats.written > 0) {
+        lastReportTime = elapsed;
         float progress = (float)exportedFrames / totalExportFrames * 100.0f;
-        float elapsed = ofGetElapsedTimef() - exportStartTime;
-        float remaining = (elapsed / exportedFrames) * (totalExportFrames - exportedFrames);
+        float remaining = (elapsed / stats.written) * (totalExportFrames - exportedFrames);
 
         std::cout << "Progress: " << exportedFrames << "/" << totalExportFrames
                   << " (" << (int)progress << "%) "
-                  << "ETA: " << formatTime(remaining) << std::endl;
+                  << "ETA: " << formatTime(remaining)
+                  << " | push " << ofToString(stats.pushFps, 1)
+                  << " / glitch " << ofToString(stats.processFps, 1)
+                  << " / write " << ofToString(stats.writeFps, 1) << " fps" << std::endl;
+    }
+
+    if (!exporter.isRunning()) {
+        exporter.wait();
+        finishExport();
     }
 }
 
-void ofApp::nextPreset() {
-    currentJobIndex++;
-
-    if (currentJobIndex >= exportJobs.size()) {
-        // All done
-        isExporting = false;
-        float totalTime = ofGetElapsedTimef() - exportStartTime;
-
-        std::cout << std::endl;
-        std::cout << "=== Export Complete ===" << std::endl;
-        std::cout << "Total frames: " << exportedFrames << std::endl;
-        std::cout << "Total time: " << formatTime(totalTime) << std::endl;
-        std::cout << "Average: " << (totalTime / exportedFrames) << " sec/frame" << std::endl;
-        std::cout << std::endl;
-        std::cout << "Output folders:" << std::endl;
-        for (const auto& job : exportJobs) {
-            std::cout << "  " << job.outputFolder << std::endl;
-        }
-        std::cout << std::endl;
-        std::cout << "Convert to video with:" << std::endl;
-        std::cout << "  ffmpeg -framerate 30 -i output/<preset>/frame_%05d.png -c:v libx264 -pix_fmt yuv420p output.mp4" << std::endl;
+void ofApp::finishExport() {
+    isExporting = false;
+    ofxGlicExportStats stats = exporter.getStats();
+    float totalTime = ofGetElapsedTimef() - exportStartTime;
+
+    std::cout << std::endl;
+    std::cout << "=== Export Complete ===" << std::endl;
+    std::cout << "Frames: " << stats.written << " x " << exportPresets.size() << " presets" << std::endl;
+    std::cout << "Total time: " << formatTime(totalTime) << std::endl;
+    if (stats.written > 0) {
+        std::cout << "Average: " << (totalTime / stats.written) << " sec/frame" << std::endl;
+    }
+    std::cout << "Glitch " << ofToString(stats.processMillisPerFrame, 1) << " ms/frame"
+              << ", write " << ofToString(stats.writeMillisPerFrame, 1) << " ms/frame"
+              << ", source waited " << ofToString(stats.pushWaitMillis / 1000.0, 1) << " s" << std::endl;
+    if (stats.failed > 0) {
+        std::cout << stats.failed << " frames failed: " << stats.lastError << std::endl;
+    }
+    std::cout << std::endl;
+    std::cout << "Output:" << std::endl;
+    for (const auto& preset : exportPresets) {
+        ofxGlicExportSettings presetSettings = ofxGlicSequenceExporter::getPresetSettings(exportSettings, preset);
+        std::cout << "  " << (exportSettings.streamOutput ? ofxGlicSequenceExporter::getStreamPath(presetSettings)
+                                                          : presetSettings.folder) << std::endl;
+    }
+    std::cout << std::endl;
+    std::cout << "Convert to video with:" << std::endl;
+    if (exportSettings.streamOutput) {
+        std::cout << "  ffmpeg -i output/<preset>/frames.y4m -c:v libx264 -pix_fmt yuv420p output.mp4" << std::endl;
     } else {
-        std::cout << "Starting preset: " << exportJobs[currentJobIndex].presetName << std::endl;
+        std::cout << "  ffmpeg -framerate 30 -i output/<preset>/frame_%05d.png -c:v libx264 -pix_fmt yuv420p output.mp4" << std::endl;
     }
 }
 
@@ -226,10 +246,7 @@ std::string ofApp::formatTime(float seconds) {
 
 void ofApp::update() {
     if (isExporting) {
-        // Process multiple frames per update for speed
-        for (int i = 0; i < 2 && isExporting; i++) {
-            processNextFrame();
-        }
+        processNextFrame();
     } else if (videoLoaded && !isPaused) {
         video.update();
         if (video.isFrameNew()) {
@@ -281,7 +298,7 @@ void ofApp::draw() {
     if (isExporting) {
         ofSetColor(255, 255, 0);
         float progress = (float)exportedFrames / totalExportFrames;
-        std::string status = "EXPORTING: " + exportJobs[currentJobIndex].presetName;
+        std::string status = "EXPORTING: " + ofToString(exportPresets.size()) + " presets";
         status += " | " + ofToString((int)(progress * 100)) + "%";
         status += " | " + ofToString(exportedFrames) + "/" + ofToString(totalExportFrames);
         ofDrawBitmapString(status, margin, 40 + vidH + 40);
@@ -323,6 +340,9 @@ void ofApp::keyPressed(int key) {
         }
     } else if (key == OF_KEY_ESC) {
         if (isExporting) {
+            // Written frames stay; the next export resumes after them
+            exporter.cancel();
+            exporter.wait();
             isExporting = false;
             std::cout << "Export cancelled!" << std::endl;
         }
@@ -336,5 +356,7 @@ void ofApp::dragEvent(ofDragInfo dragInfo) {
 }
 
 void ofApp::exit() {
+    exporter.cancel();
+    exporter.wait();
     video.close();
 }
@@ -4,14 +4,6 @@
 #include "ofxGlic.h"
 #include "ofxGui.h"
 
-struct ExportJob {
-    std::string presetName;
-    std::string outputFolder;
-    int currentFrame = 0;
-    int totalFrames = 0;
-    bool completed = false;
-};
-
 class ofApp : public ofBaseApp {
 public:
     void setup() override;
@@ -25,15 +17,18 @@ private:
     void loadVideo(const std::string& path);
     void startExport();
     void processNextFrame();
-    void nextPreset();
+    void finishExport();
     std::string formatTime(float seconds);
 
     ofVideoPlayer video;
-    ofxGlicCodec codec;
+    ofxGlicCodec codec;  // Preview only; the exporter has its own codecs
     ofxGlicEffects effects;
+    ofxGlicSequenceExporter exporter;
 
     ofImage currentFrame;
     ofImage processedFrame;
+    ofPixels processedPixels;
+    ofPixels pendingFrame;  // Decoded frame the exporter had no room for yet
 
     bool videoLoaded = false;
     bool isExporting = false;
@@ -41,11 +36,15 @@ private:
 
     // Export settings
     std::vector<std::string> selectedPresets;
-    std::vector<ExportJob> exportJobs;
-    int currentJobIndex = 0;
+    std::vector<ofxGlicPreset> exportPresets;
+    ofxGlicExportSettings exportSettings;
+    int nextExportFrame = 0;  // Next frame to push, counted from the start frame
+    int resumeFrame = 0;      // First frame not written by an earlier export
     int exportedFrames = 0;
-    int totalExportFrames = 0;
+    int totalExportFrames = 0;  // Frames per preset
     float exportStartTime = 0;
+    float lastReportTime = 0;
+    float lastPreviewTime = 0;
 
     // Frame range
     int startFrame = 0;
@@ -67,6 +66,7 @@ private:
     ofxToggle presetBlocky;
     ofxToggle presetDreamy;
     ofxToggle presetRetro;
+    ofxToggle streamToggle;  // One Y4M file per preset instead of PNG frames
 
     std::vector<std::string> presetNames;
 };
@@ -403,12 +403,13 @@ void ofApp::onEncodeButton() {
         logDebug("Reading config from GUI...");
         readConfigFromGui();
 
-        // Convert to GLIC colors
+        // View the source as GLIC colors (no copy when the pixels are already RGBA)
         logDebug("Converting image to GLIC colors...");
-        auto colors = ofImageToGlicColors(sourceImage);
-        logDebug("Converted " + std::to_string(colors.size()) + " pixels");
+        sourceColors.set(sourceImage.getPixels());
+        logDebug("Converted " + std::to_string(sourceColors.size()) + " pixels" +
+                 (sourceColors.isBorrowed() ? " (zero-copy)" : ""));
 
-        if (colors.empty()) {
+        if (sourceColors.size() == 0) {
             logError("Failed to convert image to colors");
             return;
         }
@@ -419,22 +420,17 @@ void ofApp::onEncodeButton() {
 
         // Encode
         logDebug("Calling codec.encode()...");
-        auto result = codec.encode(colors.data(), width, height, outputPath);
+        auto result = codec.encode(sourceColors.data(), width, height, outputPath);
 
         if (result.success) {
             log("Encode SUCCESS");
 
-            // Decode to show result
-            logDebug("Decoding result for preview...");
-            auto decResult = codec.decode(outputPath);
-            if (decResult.success) {
-                glicColorsToOfImage(decResult.pixels, decResult.width, decResult.height, resultImage);
-                currentDisplay = &resultImage;
-                displayMode = 3;
-                log("Done! Result size: " + std::to_string(decResult.width) + "x" + std::to_string(decResult.height));
-            } else {
-                logError("Preview decode failed: " + decResult.error);
-            }
+            // encode() already returns the reconstructed image, so the preview
+            // does not need to read the file back and decode it again
+            glicColorsToOfImage(result.pixels, result.width, result.height, resultImage);
+            currentDisplay = &resultImage;
+            displayMode = 3;
+            log("Done! Result size: " + std::to_string(result.width) + "x" + std::to_string(result.height));
         } else {
             logError("Encode FAILED: " + result.error);
         }
@@ -590,46 +586,16 @@ void ofApp::readConfigFromGui() {
     logDebug("Config applied to codec");
 }
 
-std::vector<glic::Color> ofApp::ofImageToGlicColors(const ofImage& img) {
-    std::vector<glic::Color> colors;
-    int width = img.getWidth();
-    int height = img.getHeight();
-
-    logDebug("Converting ofImage " + std::to_string(width) + "x" + std::to_string(height) + " to GLIC colors");
-
-    colors.resize(width * height);
-    const ofPixels& pixels = img.getPixels();
-
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            ofColor c = pixels.getColor(x, y);
-            colors[idx] = glic::makeColor(c.r, c.g, c.b, c.a);
-        }
-    }
-
-    logDebug("Conversion complete: " + std::to_string(colors.size()) + " colors");
-    return colors;
-}
-
 void ofApp::glicColorsToOfImage(const std::vector<glic::Color>& colors, int width, int height, ofImage& img) {
     logDebug("Converting " + std::to_string(colors.size()) + " GLIC colors to ofImage " +
              std::to_string(width) + "x" + std::to_string(height));
 
-    img.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
-    ofPixels& pixels = img.getPixels();
-
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            if (idx < (int)colors.size()) {
-                glic::Color c = colors[idx];
-                pixels.setColor(x, y, ofColor(glic::getR(c), glic::getG(c), glic::getB(c), glic::getA(c)));
-            }
-        }
+    if (colors.size() < size_t(width) * size_t(height)) {
+        logError("Decoded pixel count does not match image size");
+        return;
     }
+    ofxGlic::toOfImage(colors, width, height, img);
 
-    img.update();
     logDebug("Image conversion complete");
 }
 
@@ -44,7 +44,6 @@ private:
 
     // Codec helpers
     void readConfigFromGui();
-    std::vector<glic::Color> ofImageToGlicColors(const ofImage& img);
     void glicColorsToOfImage(const std::vector<glic::Color>& colors, int width, int height, ofImage& img);
 
     // Images
@@ -61,6 +60,7 @@ private:
 
     // Codec
     glic::GlicCodec codec;
+    ofxGlicColorView sourceColors;
 
     // File paths
     std::string currentFilePath;
@@ -5,8 +5,21 @@
 #include "glic/glic.hpp"
 #include "glic/colorspaces.hpp"
 #include "glic/effects.hpp"
+#include "ofxGlicSimd.h"
+#include "ofxGlicPixels.h"
+#include "ofxGlicThreadPool.h"
+#include "ofxGlicTiles.h"
+#include "ofxGlicMappedFile.h"
+#include "ofxGlicWorkspace.h"
 #include "ofxGlicCodec.h"
+#include "ofxGlicCodecPool.h"
+#include "ofxGlicColorLut.h"
 #include "ofxGlicEffects.h"
+#include "ofxGlicAsyncCodec.h"
+#include "ofxGlicSession.h"
+#include "ofxGlicBatchProcessor.h"
+#include "ofxGlicFrameWriter.h"
+#include "ofxGlicSequenceExporter.h"
 #include "ofxGlicPresets.h"
 
 // Main include file for ofxGlic addon
@@ -25,34 +38,13 @@ namespace ofxGlic {
     // Convert ofImage to GLIC color array
     inline std::vector<glic::Color> toGlicColors(const ofImage& img) {
         std::vector<glic::Color> colors;
-        int width = img.getWidth();
-        int height = img.getHeight();
-        colors.resize(width * height);
-
-        const ofPixels& pixels = img.getPixels();
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                int idx = y * width + x;
-                ofColor c = pixels.getColor(x, y);
-                colors[idx] = glic::makeColor(c.r, c.g, c.b, c.a);
-            }
-        }
+        toGlicColors(img.getPixels(), colors);
         return colors;
     }
 
     // Convert GLIC color array to ofImage
     inline void toOfImage(const std::vector<glic::Color>& colors, int width, int height, ofImage& img) {
-        img.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
-        ofPixels& pixels = img.getPixels();
-
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                int idx = y * width + x;
-                glic::Color c = colors[idx];
-                pixels.setColor(x, y, ofColor(glic::getR(c), glic::getG(c), glic::getB(c), glic::getA(c)));
-            }
-        }
-        img.update();
+        ofxGlicCodec::toOfImage(colors, width, height, img);
     }
 
     // Get color space name
@@ -0,0 +1,248 @@
+#include "ofxGlicAsyncCodec.h"
+#include "ofxGlicCodec.h"
+
+ofxGlicAsyncCodec::~ofxGlicAsyncCodec() {
+    close();
+}
+
+void ofxGlicAsyncCodec::setup(size_t numThreads, size_t maxQueueSize) {
+    close();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxQueueSize_ = std::max<size_t>(1, maxQueueSize);
+    numThreads_ = std::max<size_t>(1, numThreads);
+    stats_ = ofxGlicAsyncStats();
+    totalLatencyMillis_ = 0;
+    startWorkers();
+}
+
+void ofxGlicAsyncCodec::startWorkers() {
+    if (!workers_.empty()) return;
+    for (size_t i = 0; i < numThreads_; i++) {
+        workers_.emplace_back(&ofxGlicAsyncCodec::workerLoop, this, generation_);
+    }
+}
+
+void ofxGlicAsyncCodec::close() {
+    // Joined outside the lock, which the workers need to finish; a submit
+    // meanwhile starts a new generation of workers
+    std::vector<std::thread> workers;
+    std::deque<std::unique_ptr<Job>> waiting;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (workers_.empty()) return;
+        generation_++;
+        workers.swap(workers_);
+        waiting.swap(queue_);
+    }
+    condition_.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (auto& job : waiting) {
+        ofxGlicAsyncResult result;
+        result.dropped = true;
+        result.error = "Codec closed";
+        finish(std::move(job), std::move(result));
+    }
+}
+
+std::future<ofxGlicAsyncResult> ofxGlicAsyncCodec::submit(const ofPixels& frame, const glic::CodecConfig& config,
+                                                          const std::vector<ofxGlicEffect>& effects) {
+    std::future<ofxGlicAsyncResult> future;
+    uint64_t id;
+    std::unique_ptr<Job> dropped = enqueue(frame, config, effects, nullptr, &future, id);
+    if (dropped) {
+        ofxGlicAsyncResult result;
+        result.dropped = true;
+        result.error = "Dropped: queue full";
+        finish(std::move(dropped), std::move(result));
+    }
+    return future;
+}
+
+uint64_t ofxGlicAsyncCodec::submit(const ofPixels& frame, const glic::CodecConfig& config, Callback onComplete,
+                                   const std::vector<ofxGlicEffect>& effects) {
+    uint64_t id;
+    std::unique_ptr<Job> dropped = enqueue(frame, config, effects, std::move(onComplete), nullptr, id);
+    if (dropped) {
+        ofxGlicAsyncResult result;
+        result.dropped = true;
+        result.error = "Dropped: queue full";
+        finish(std::move(dropped), std::move(result));
+    }
+    return id;
+}
+
+std::unique_ptr<ofxGlicAsyncCodec::Job> ofxGlicAsyncCodec::enqueue(const ofPixels& frame, const glic::CodecConfig& config,
+                                                                   const std::vector<ofxGlicEffect>& effects,
+                                                                   Callback callback,
+                                                                   std::future<ofxGlicAsyncResult>* future,
+                                                                   uint64_t& id) {
+    std::unique_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!freeJobs_.empty()) {
+            job = std::move(freeJobs_.back());
+            freeJobs_.pop_back();
+        }
+    }
+    if (!job) {
+        job = std::make_unique<Job>();
+    }
+
+    // Copy outside the lock; a recycled job keeps its pixel allocation
+    job->frame = frame;
+    job->config = config;
+    job->effects = effects;
+    job->promise = std::promise<ofxGlicAsyncResult>();
+    job->callback = std::move(callback);
+    job->submitTime = Clock::now();
+    if (future) {
+        *future = job->promise.get_future();
+    }
+
+    std::unique_ptr<Job> dropped;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        startWorkers();
+        job->id = id = nextJobId_++;
+        if (queue_.size() >= maxQueueSize_) {
+            dropped = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        queue_.push_back(std::move(job));
+        stats_.submitted++;
+    }
+    condition_.notify_one();
+    return dropped;
+}
+
+void ofxGlicAsyncCodec::finish(std::unique_ptr<Job> job, ofxGlicAsyncResult result) {
+    result.jobId = job->id;
+    result.latencyMillis = std::chrono::duration<double, std::milli>(Clock::now() - job->submitTime).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (result.dropped) {
+        stats_.dropped++;
+    } else {
+        if (result.success) {
+            stats_.completed++;
+        } else {
+            stats_.failed++;
+        }
+        stats_.lastLatencyMillis = result.latencyMillis;
+        stats_.maxLatencyMillis = std::max(stats_.maxLatencyMillis, result.latencyMillis);
+        totalLatencyMillis_ += result.latencyMillis;
+        stats_.averageLatencyMillis = totalLatencyMillis_ / double(stats_.completed + stats_.failed);
+    }
+
+    if (job->callback) {
+        completions_.push_back({std::move(job->callback), std::move(result)});
+    } else {
+        job->promise.set_value(std::move(result));
+    }
+
+    job->callback = nullptr;
+    if (freeJobs_.size() < maxQueueSize_ + numThreads_) {
+        freeJobs_.push_back(std::move(job));
+    }
+}
+
+void ofxGlicAsyncCodec::setStreamMode(bool enabled, float threshold, int tileSize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streamMode_ = enabled;
+    streamThreshold_ = threshold;
+    streamTileSize_ = enabled ? tileSize : 0;
+}
+
+void ofxGlicAsyncCodec::update() {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready.swap(completions_);
+    }
+    for (auto& completion : ready) {
+        completion.callback(completion.result);
+    }
+}
+
+bool ofxGlicAsyncCodec::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !workers_.empty();
+}
+
+size_t ofxGlicAsyncCodec::getQueueDepth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+ofxGlicAsyncStats ofxGlicAsyncCodec::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ofxGlicAsyncStats stats = stats_;
+    stats.queueDepth = queue_.size();
+    return stats;
+}
+
+void ofxGlicAsyncCodec::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t inFlight = stats_.inFlight;
+    stats_ = ofxGlicAsyncStats();
+    stats_.inFlight = inFlight;
+    totalLatencyMillis_ = 0;
+}
+
+void ofxGlicAsyncCodec::workerLoop(uint64_t generation) {
+    // Each worker owns its codec and effects so jobs never share state;
+    // both draw their scratch buffers from one workspace
+    ofxGlicWorkspace workspace;
+    ofxGlicCodec codec;
+    ofxGlicEffects effects;
+    codec.setWorkspace(&workspace);
+    effects.setWorkspace(&workspace);
+
+    while (true) {
+        std::unique_ptr<Job> job;
+        bool streamMode;
+        float streamThreshold;
+        int streamTileSize;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [&] { return generation_ != generation || !queue_.empty(); });
+            if (generation_ != generation) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            stats_.inFlight++;
+            streamMode = streamMode_;
+            streamThreshold = streamThreshold_;
+            streamTileSize = streamTileSize_;
+        }
+
+        ofxGlicAsyncResult result;
+        try {
+            codec.setConfig(job->config);
+            codec.setStreamMode(streamMode, streamThreshold);
+            codec.setTiling(streamTileSize > 0, streamTileSize);
+            result.success = codec.glitch(job->frame, result.pixels);
+            if (result.success) {
+                if (!job->effects.empty()) {
+                    effects.setEffects(job->effects);
+                    effects.apply(result.pixels);
+                }
+            } else {
+                result.error = codec.getLastError();
+            }
+        } catch (const std::exception& e) {
+            result.success = false;
+            result.error = e.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.inFlight--;
+        }
+        finish(std::move(job), std::move(result));
+    }
+}
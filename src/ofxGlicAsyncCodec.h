@@ -0,0 +1,129 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGlicConfig.h"
+#include "ofxGlicEffects.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Result of one background job
+struct ofxGlicAsyncResult {
+    ofPixels pixels;
+    bool success = false;
+    bool dropped = false;  // Pushed out of the queue by newer frames before it started
+    std::string error;
+    uint64_t jobId = 0;
+    double latencyMillis = 0;  // From submit() until the job finished
+
+    operator bool() const { return success; }
+};
+
+// Counters since setup() or resetStats()
+struct ofxGlicAsyncStats {
+    size_t queueDepth = 0;  // Jobs waiting for a worker
+    size_t inFlight = 0;    // Jobs being processed
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t dropped = 0;
+    double lastLatencyMillis = 0;
+    double averageLatencyMillis = 0;
+    double maxLatencyMillis = 0;
+};
+
+// Glitches frames on background threads
+// Each job carries a copy of the frame plus the codec config and effects it
+// should use, so the caller can keep changing settings while jobs run.
+// The queue is bounded: when it is full the oldest waiting job is dropped,
+// so submitting never blocks.
+class ofxGlicAsyncCodec {
+public:
+    using Callback = std::function<void(const ofxGlicAsyncResult&)>;
+
+    ofxGlicAsyncCodec() = default;
+    ~ofxGlicAsyncCodec();
+
+    ofxGlicAsyncCodec(const ofxGlicAsyncCodec&) = delete;
+    ofxGlicAsyncCodec& operator=(const ofxGlicAsyncCodec&) = delete;
+
+    // Start the worker threads (started with the current settings by the
+    // first submit otherwise)
+    void setup(size_t numThreads = 1, size_t maxQueueSize = 2);
+
+    // Stop the workers after their current job; waiting jobs are dropped
+    void close();
+    bool isRunning() const;
+
+    // Queue a frame; the future is ready when the job finishes or is dropped
+    std::future<ofxGlicAsyncResult> submit(const ofPixels& frame, const glic::CodecConfig& config,
+                                           const std::vector<ofxGlicEffect>& effects = {});
+
+    // Queue a frame; onComplete runs inside update() on the thread calling it
+    // Returns the job id.
+    uint64_t submit(const ofPixels& frame, const glic::CodecConfig& config, Callback onComplete,
+                    const std::vector<ofxGlicEffect>& effects = {});
+
+    // Stream mode of the worker codecs (see ofxGlicCodec::setStreamMode)
+    // tileSize > 0 also turns on tiling, so unchanged parts of a frame are
+    // reused rather than only whole unchanged frames. Each worker compares
+    // against the last frame it processed, so reuse is best with one worker.
+    void setStreamMode(bool enabled, float threshold = 1.0f, int tileSize = 0);
+
+    // Run the callbacks of finished jobs (call from ofApp::update())
+    void update();
+
+    size_t getQueueDepth() const;
+    size_t getMaxQueueSize() const { return maxQueueSize_; }
+    ofxGlicAsyncStats getStats() const;
+    void resetStats();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        uint64_t id = 0;
+        ofPixels frame;
+        glic::CodecConfig config;
+        std::vector<ofxGlicEffect> effects;
+        std::promise<ofxGlicAsyncResult> promise;
+        Callback callback;
+        Clock::time_point submitTime;
+    };
+
+    struct Completion {
+        Callback callback;
+        ofxGlicAsyncResult result;
+    };
+
+    std::unique_ptr<Job> enqueue(const ofPixels& frame, const glic::CodecConfig& config,
+                                 const std::vector<ofxGlicEffect>& effects, Callback callback,
+                                 std::future<ofxGlicAsyncResult>* future, uint64_t& id);
+    void finish(std::unique_ptr<Job> job, ofxGlicAsyncResult result);
+    // Start numThreads_ workers unless they are running (call with mutex_ held)
+    void startWorkers();
+    void workerLoop(uint64_t generation);
+
+    std::vector<std::thread> workers_;  // Guarded by mutex_ like everything below
+    std::deque<std::unique_ptr<Job>> queue_;
+    std::vector<std::unique_ptr<Job>> freeJobs_;  // Recycled so frame copies keep their allocation
+    std::vector<Completion> completions_;
+    size_t maxQueueSize_ = 2;
+    size_t numThreads_ = 1;
+    uint64_t nextJobId_ = 1;
+    uint64_t generation_ = 0;  // Bumped by close(); workers of an older generation exit
+    bool streamMode_ = false;
+    float streamThreshold_ = 1.0f;
+    int streamTileSize_ = 0;
+    ofxGlicAsyncStats stats_;
+    double totalLatencyMillis_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+};
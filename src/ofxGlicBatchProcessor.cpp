@@ -0,0 +1,125 @@
+#include "ofxGlicBatchProcessor.h"
+#include "ofxGlicCodecPool.h"
+#include "ofxGlicThreadPool.h"
+#include <algorithm>
+
+ofxGlicBatchProcessor::~ofxGlicBatchProcessor() {
+    cancel();
+    wait();
+}
+
+std::vector<ofxGlicBatchJob> ofxGlicBatchProcessor::makeJobs(const std::vector<std::string>& inputPaths,
+                                                             const std::string& outputFolder,
+                                                             const std::string& suffix) {
+    std::vector<ofxGlicBatchJob> jobs(inputPaths.size());
+    for (size_t i = 0; i < inputPaths.size(); i++) {
+        jobs[i].inputPath = inputPaths[i];
+        jobs[i].outputPath = ofFilePath::join(outputFolder, ofFilePath::getBaseName(inputPaths[i]) + suffix + ".png");
+    }
+    return jobs;
+}
+
+bool ofxGlicBatchProcessor::start(std::vector<ofxGlicBatchJob> jobs, const ofxGlicPreset& preset,
+                                  const std::vector<ofxGlicEffect>& extraEffects) {
+    if (running_) return false;
+    wait();
+
+    jobs_ = std::move(jobs);
+    numJobs_ = jobs_.size();
+    states_.reset(new std::atomic<ofxGlicBatchJob::State>[numJobs_]);
+    for (size_t i = 0; i < numJobs_; i++) {
+        states_[i] = ofxGlicBatchJob::State::Pending;
+    }
+
+    config_ = ofxGlic::makeConfigSnapshot(preset.codecConfig);
+    std::vector<ofxGlicEffect> effects = preset.effects;
+    effects.insert(effects.end(), extraEffects.begin(), extraEffects.end());
+    effects_ = ofxGlicEffectChain::get(effects);
+
+    cancelled_ = false;
+    finished_ = 0;
+    failed_ = 0;
+    if (numJobs_ == 0) return true;
+
+    // The runner is a pool task rather than a thread of our own: the codec
+    // pool keeps a codec per thread, and pool threads keep theirs between
+    // batches. Its parallelFor uses the runner's thread too, so concurrency
+    // counts it.
+    ofxGlicThreadPool& pool = ofxGlicThreadPool::shared();
+    size_t concurrency = maxConcurrency_ > 0 ? maxConcurrency_ : pool.getNumThreads();
+    concurrency = std::max<size_t>(1, std::min(concurrency, numJobs_));
+    running_ = true;
+    runner_ = pool.submit([this, concurrency] { run(concurrency); });
+    return true;
+}
+
+void ofxGlicBatchProcessor::cancel() {
+    cancelled_ = true;
+}
+
+void ofxGlicBatchProcessor::wait() {
+    if (runner_.valid()) {
+        runner_.wait();
+        runner_ = {};
+    }
+}
+
+void ofxGlicBatchProcessor::run(size_t concurrency) {
+    ofxGlicThreadPool::shared().parallelFor(numJobs_, [this](size_t index) { process(index); }, concurrency);
+    running_ = false;
+}
+
+void ofxGlicBatchProcessor::process(size_t index) {
+    ofxGlicBatchJob& job = jobs_[index];
+    auto finish = [&](ofxGlicBatchJob::State state) {
+        if (state == ofxGlicBatchJob::State::Failed) failed_++;
+        states_[index] = state;
+        finished_++;
+    };
+
+    if (cancelled_) {
+        job.error = "Cancelled";
+        finish(ofxGlicBatchJob::State::Cancelled);
+        return;
+    }
+    states_[index] = ofxGlicBatchJob::State::Running;
+
+    try {
+        ofPixels source;
+        if (!job.inputPath.empty()) {
+            if (!ofLoadImage(source, job.inputPath)) {
+                job.error = "Failed to load " + job.inputPath;
+                finish(ofxGlicBatchJob::State::Failed);
+                return;
+            }
+        } else {
+            // Leaves job.pixels unallocated, ready for the result
+            source.swap(job.pixels);
+        }
+
+        ofxGlicCodec& codec = ofxGlicCodecPool::shared().get(config_);
+        if (!codec.glitch(source, job.pixels)) {
+            job.error = codec.getLastError();
+            finish(ofxGlicBatchJob::State::Failed);
+            return;
+        }
+
+        effects_->apply(job.pixels, codec.getWorkspace());
+
+        if (!job.outputPath.empty()) {
+            if (!ofSaveImage(job.pixels, job.outputPath)) {
+                job.error = "Failed to save " + job.outputPath;
+                finish(ofxGlicBatchJob::State::Failed);
+                return;
+            }
+            // Saved results do not stay in memory
+            job.pixels.clear();
+        }
+    } catch (const std::exception& e) {
+        job.error = e.what();
+        finish(ofxGlicBatchJob::State::Failed);
+        return;
+    }
+
+    finish(ofxGlicBatchJob::State::Done);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGlicConfig.h"
+#include "ofxGlicPresets.h"
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One image of a batch
+// The source is inputPath, or pixels when inputPath is empty. The result is
+// saved to outputPath, or kept in pixels when outputPath is empty.
+struct ofxGlicBatchJob {
+    enum class State { Pending, Running, Done, Failed, Cancelled };
+
+    std::string inputPath;
+    std::string outputPath;
+    ofPixels pixels;
+    std::string error;  // Why the job failed
+};
+
+// Glitches many images on ofxGlicThreadPool::shared()
+// Each job is load -> glitch -> effects -> save on one pool thread, with the
+// thread's codec from ofxGlicCodecPool::shared(). start() queues one pool
+// task that runs the jobs with parallelFor, so its helper tasks go to that
+// thread's own deque and the other pool threads steal them. Jobs only run on
+// pool threads, so every batch reuses the same codecs. start() returns at
+// once; progress is readable from any thread while the batch runs.
+class ofxGlicBatchProcessor {
+public:
+    ofxGlicBatchProcessor() = default;
+    ~ofxGlicBatchProcessor();
+
+    ofxGlicBatchProcessor(const ofxGlicBatchProcessor&) = delete;
+    ofxGlicBatchProcessor& operator=(const ofxGlicBatchProcessor&) = delete;
+
+    // Jobs for files, each saved to outputFolder as <name><suffix>.png
+    static std::vector<ofxGlicBatchJob> makeJobs(const std::vector<std::string>& inputPaths,
+                                                 const std::string& outputFolder,
+                                                 const std::string& suffix = "_glitched");
+
+    // Most jobs run at once (0 = one per pool thread)
+    void setMaxConcurrency(size_t maxConcurrency) { maxConcurrency_ = maxConcurrency; }
+    size_t getMaxConcurrency() const { return maxConcurrency_; }
+
+    // Start processing with the preset's config and effects, followed by
+    // extraEffects; false if a batch is still running
+    bool start(std::vector<ofxGlicBatchJob> jobs, const ofxGlicPreset& preset,
+               const std::vector<ofxGlicEffect>& extraEffects = {});
+
+    // Skip the jobs that have not started; running jobs finish
+    void cancel();
+
+    // Block until the batch has finished or been cancelled
+    // Not from a task on ofxGlicThreadPool::shared(), which runs the jobs
+    void wait();
+
+    bool isRunning() const { return running_.load(); }
+
+    // Progress, safe to call while running
+    size_t getNumJobs() const { return numJobs_; }
+    size_t getNumFinished() const { return finished_.load(); }  // Done, failed or cancelled
+    size_t getNumFailed() const { return failed_.load(); }
+    float getProgress() const { return numJobs_ ? float(getNumFinished()) / float(numJobs_) : 1.0f; }
+    ofxGlicBatchJob::State getJobState(size_t index) const { return states_[index].load(); }
+
+    // Jobs with their errors and kept pixels; only read once isRunning() is false
+    const std::vector<ofxGlicBatchJob>& getJobs() const { return jobs_; }
+
+private:
+    // Pool task: process every job, at most concurrency at once
+    void run(size_t concurrency);
+    void process(size_t index);
+
+    std::vector<ofxGlicBatchJob> jobs_;
+    std::unique_ptr<std::atomic<ofxGlicBatchJob::State>[]> states_;
+    size_t numJobs_ = 0;
+    ofxGlicConfigSnapshot config_;
+    std::shared_ptr<const ofxGlicEffectChain> effects_;  // Preset and extra effects, compiled once
+    size_t maxConcurrency_ = 0;
+
+    std::future<void> runner_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<size_t> finished_{0};
+    std::atomic<size_t> failed_{0};
+};
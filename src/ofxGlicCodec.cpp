@@ -1,15 +1,149 @@
 #include "ofxGlicCodec.h"
+#include "ofxGlicCodecPool.h"
+#include "ofxGlicColorLut.h"
+#include "ofxGlicMappedFile.h"
+#include "ofxGlicThreadPool.h"
 #include "glic/glic.hpp"
+#include "glic/colorspaces.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+struct ofxGlicCodec::TileLane {
+    glic::GlicCodec codec;
+    std::vector<glic::Color> colors;
+    std::vector<uint8_t> bytes;
+};
+
+struct ofxGlicCodec::ChannelLane {
+    glic::GlicCodec codec;
+    glic::CodecConfig config;  // What codec is configured with
+    bool configured = false;
+    std::vector<uint8_t> bytes;
+    std::vector<glic::Color> decoded;
+};
+
+namespace {
+    // Reads the rest of a stream into bytes (reuses their storage)
+    bool readStream(std::istream& stream, std::vector<uint8_t>& bytes) {
+        bytes.clear();
+
+        // Seekable streams are read in one go
+        std::streampos start = stream.tellg();
+        if (start != std::streampos(-1) && stream.seekg(0, std::ios::end)) {
+            std::streamoff size = stream.tellg() - start;
+            stream.seekg(start);
+            if (size > 0) {
+                bytes.resize(size_t(size));
+                stream.read(reinterpret_cast<char*>(bytes.data()), size);
+                bytes.resize(size_t(stream.gcount()));
+                return !bytes.empty();
+            }
+        }
+        stream.clear();
+
+        char chunk[64 * 1024];
+        while (stream.read(chunk, sizeof(chunk)) || stream.gcount() > 0) {
+            bytes.insert(bytes.end(), chunk, chunk + stream.gcount());
+        }
+        return !bytes.empty();
+    }
+
+    // Side of the cells a stream tile is compared in; small enough that a
+    // small moving object shows in its cell's mean
+    const int streamCellSize = 16;
+
+    int colorDifference(const glic::Color& a, const glic::Color& b) {
+        return std::abs(int(glic::getR(a)) - int(glic::getR(b))) +
+               std::abs(int(glic::getG(a)) - int(glic::getG(b))) +
+               std::abs(int(glic::getB(a)) - int(glic::getB(b)));
+    }
+
+    // True when every streamCellSize cell of the tile has a mean absolute
+    // difference per color channel of at most threshold; alpha is ignored
+    bool tileMatches(const glic::Color* a, const glic::Color* b, int stride, int x, int y, int w, int h,
+                     float threshold) {
+        for (int cy = 0; cy < h; cy += streamCellSize) {
+            int ch = std::min(streamCellSize, h - cy);
+            for (int cx = 0; cx < w; cx += streamCellSize) {
+                int cw = std::min(streamCellSize, w - cx);
+                uint32_t limit = uint32_t(double(threshold) * cw * ch * 3);
+                uint32_t total = 0;
+                for (int row = 0; row < ch; row++) {
+                    size_t offset = size_t(y + cy + row) * stride + x + cx;
+                    for (int i = 0; i < cw; i++) {
+                        total += uint32_t(colorDifference(a[offset + i], b[offset + i]));
+                    }
+                    if (total > limit) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Settings that make glic do as little as possible for a channel whose
+    // result is thrown away
+    glic::ChannelConfig makeIdleChannel() {
+        glic::ChannelConfig channel;
+        channel.minBlockSize = 256;
+        channel.maxBlockSize = 256;
+        channel.predictionMethod = glic::PredictionMethod::NONE;
+        channel.quantizationValue = 0;
+        channel.clampMethod = glic::ClampMethod::NONE;
+        channel.waveletType = glic::WaveletType::NONE;
+        channel.transformCompress = 0;
+        channel.encodingMethod = glic::EncodingMethod::RAW;
+        return channel;
+    }
 
-ofxGlicCodec::ofxGlicCodec() : codec_(std::make_unique<glic::GlicCodec>()), config_() {
-    codec_->setConfig(config_);
+    // Config of the codec that carries one channel in per-channel mode
+    // Its input is already in config's color space, so it selects RGB, which
+    // glic leaves unchanged; the border color is converted the same way.
+    glic::CodecConfig makeChannelConfig(const glic::CodecConfig& config, int channel) {
+        glic::CodecConfig result = config;
+        result.colorSpace = glic::ColorSpace::RGB;
+        glic::Color border = glic::toColorspace(
+            glic::makeColor(config.borderColorR, config.borderColorG, config.borderColorB), config.colorSpace);
+        result.borderColorR = glic::getR(border);
+        result.borderColorG = glic::getG(border);
+        result.borderColorB = glic::getB(border);
+        for (int c = 0; c < 3; c++) {
+            if (c != channel) result.channels[c] = makeIdleChannel();
+        }
+        return result;
+    }
+
+    // Codecs of encodeImage/decodeImage, apart from ofxGlicCodecPool::shared()
+    // so the tiling, stream mode or effects its users set never reach them
+    ofxGlicCodecPool& getHelperPool() {
+        static ofxGlicCodecPool pool;
+        return pool;
+    }
+
+    bool writeFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+        std::ofstream file(path, std::ios::binary);
+        return file && file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+}
+
+ofxGlicCodec::ofxGlicCodec() : config_() {
+    applyConfig();
 }
 
 ofxGlicCodec::~ofxGlicCodec() = default;
 
 void ofxGlicCodec::setConfig(const glic::CodecConfig& config) {
     config_ = config;
-    codec_->setConfig(config);
+    applyConfig();
+}
+
+void ofxGlicCodec::setConfig(const ofxGlicConfigSnapshot& config) {
+    if (config) {
+        setConfig(*config);
+    }
 }
 
 glic::CodecConfig& ofxGlicCodec::getConfig() {
@@ -22,14 +156,14 @@ const glic::CodecConfig& ofxGlicCodec::getConfig() const {
 
 void ofxGlicCodec::setColorSpace(glic::ColorSpace cs) {
     config_.colorSpace = cs;
-    codec_->setConfig(config_);
+    applyConfig();
 }
 
 void ofxGlicCodec::setBorderColor(uint8_t r, uint8_t g, uint8_t b) {
     config_.borderColorR = r;
     config_.borderColorG = g;
     config_.borderColorB = b;
-    codec_->setConfig(config_);
+    applyConfig();
 }
 
 void ofxGlicCodec::setBorderColor(const ofColor& c) {
@@ -39,7 +173,7 @@ void ofxGlicCodec::setBorderColor(const ofColor& c) {
 void ofxGlicCodec::setChannelConfig(int channel, const glic::ChannelConfig& config) {
     if (channel >= 0 && channel < 3) {
         config_.channels[channel] = config;
-        codec_->setConfig(config_);
+        applyConfig();
     }
 }
 
@@ -47,45 +181,94 @@ glic::ChannelConfig& ofxGlicCodec::getChannelConfig(int channel) {
     return config_.channels[std::min(2, std::max(0, channel))];
 }
 
-std::vector<glic::Color> ofxGlicCodec::toGlicColors(const ofImage& img) {
-    std::vector<glic::Color> colors;
-    int width = img.getWidth();
-    int height = img.getHeight();
-    colors.resize(width * height);
+void ofxGlicCodec::setConfigCacheSize(size_t size) {
+    configCacheSize_ = std::max<size_t>(1, size);
+    while (configCache_.size() > configCacheSize_) {
+        configCache_.pop_back();
+    }
+}
 
-    const ofPixels& pixels = img.getPixels();
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            ofColor c = pixels.getColor(x, y);
-            colors[idx] = glic::makeColor(c.r, c.g, c.b, c.a);
+void ofxGlicCodec::applyConfig() {
+    // Unchanged: nothing to do. Compared against the active codec's own copy,
+    // so edits made through getConfig() are still picked up.
+    if (!configCache_.empty() && ofxGlic::configEquals(configCache_.front().config, config_)) {
+        return;
+    }
+
+    // Seen recently: switch back to the codec already configured for it
+    uint64_t hash = ofxGlic::configHash(config_);
+    for (auto it = configCache_.begin(); it != configCache_.end(); ++it) {
+        if (it->hash == hash && ofxGlic::configEquals(it->config, config_)) {
+            configCache_.splice(configCache_.begin(), configCache_, it);
+            codec_ = configCache_.front().codec.get();
+            configCacheHits_++;
+            return;
         }
     }
+
+    ConfigCacheEntry entry;
+    entry.config = config_;
+    entry.hash = hash;
+    entry.codec = std::make_unique<glic::GlicCodec>();
+    entry.codec->setConfig(config_);
+    configCache_.push_front(std::move(entry));
+    codec_ = configCache_.front().codec.get();
+    configCacheMisses_++;
+
+    while (configCache_.size() > configCacheSize_) {
+        configCache_.pop_back();
+    }
+}
+
+void ofxGlicCodec::setWorkspace(ofxGlicWorkspace* workspace) {
+    externalWorkspace_ = workspace;
+}
+
+void ofxGlicCodec::setTiling(bool enabled, int tileSize) {
+    tiling_ = enabled;
+    tileSize_ = std::max(16, tileSize);
+}
+
+std::vector<glic::Color> ofxGlicCodec::toGlicColors(const ofImage& img) {
+    std::vector<glic::Color> colors;
+    ofxGlic::toGlicColors(img.getPixels(), colors);
     return colors;
 }
 
 void ofxGlicCodec::toOfImage(const std::vector<glic::Color>& colors, int width, int height, ofImage& img) {
-    img.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
-    ofPixels& pixels = img.getPixels();
-
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            glic::Color c = colors[idx];
-            pixels.setColor(x, y, ofColor(glic::getR(c), glic::getG(c), glic::getB(c), glic::getA(c)));
-        }
+    // Reallocating also recreates the texture, so only do it when the shape changes
+    if (!img.isAllocated() || (int)img.getWidth() != width || (int)img.getHeight() != height ||
+        img.getImageType() != OF_IMAGE_COLOR_ALPHA) {
+        img.allocate(width, height, OF_IMAGE_COLOR_ALPHA);
     }
+    ofxGlic::toOfPixels(colors.data(), width, height, img.getPixels());
     img.update();
 }
 
 ofxGlicResult ofxGlicCodec::encode(const ofImage& source, const std::string& outputPath) {
+    ofxGlicWorkspace::Scope scope(workspace());
     ofxGlicResult result;
 
-    auto colors = toGlicColors(source);
-    int width = source.getWidth();
-    int height = source.getHeight();
+    sourceView_.set(source.getPixels(), workspace().acquireColors(0));
+
+    if (tiling_) {
+        std::vector<uint8_t>& buffer = workspace().acquireBytes();
+        std::vector<glic::Color>& colors = workspace().acquireColors(0);
+        int width, height;
+        if (!encodeTiled(sourceView_.data(), sourceView_.getWidth(), sourceView_.getHeight(), buffer)) {
+            result.error = lastError_;
+        } else if (!writeFile(outputPath, buffer)) {
+            result.error = "Failed to write " + outputPath;
+        } else if (!decodeTiled(buffer.data(), buffer.size(), colors, width, height)) {
+            result.error = lastError_;
+        } else {
+            result.success = true;
+            toOfImage(colors, width, height, result.image);
+        }
+        return result;
+    }
 
-    auto glicResult = codec_->encode(colors.data(), width, height, outputPath);
+    auto glicResult = codec_->encode(sourceView_.data(), sourceView_.getWidth(), sourceView_.getHeight(), outputPath);
 
     if (glicResult.success) {
         result.success = true;
@@ -99,16 +282,49 @@ ofxGlicResult ofxGlicCodec::encode(const ofImage& source, const std::string& out
 }
 
 std::vector<uint8_t> ofxGlicCodec::encodeToBuffer(const ofImage& source) {
-    auto colors = toGlicColors(source);
-    int width = source.getWidth();
-    int height = source.getHeight();
+    ofxGlicWorkspace::Scope scope(workspace());
+    sourceView_.set(source.getPixels(), workspace().acquireColors(0));
+
+    if (tiling_) {
+        std::vector<uint8_t> buffer;
+        encodeTiled(sourceView_.data(), sourceView_.getWidth(), sourceView_.getHeight(), buffer);
+        return buffer;
+    }
 
-    return codec_->encodeToBuffer(colors.data(), width, height);
+    return codec_->encodeToBuffer(sourceView_.data(), sourceView_.getWidth(), sourceView_.getHeight());
+}
+
+bool ofxGlicCodec::encodeFrom(const ofPixels& source, std::vector<uint8_t>& reuseBuffer) {
+    ofxGlicWorkspace::Scope scope(workspace());
+    sourceView_.set(source, workspace().acquireColors(0));
+    return encodeFrom(sourceView_.data(), sourceView_.getWidth(), sourceView_.getHeight(), reuseBuffer);
+}
+
+bool ofxGlicCodec::encodeFrom(const glic::Color* colors, int width, int height, std::vector<uint8_t>& reuseBuffer) {
+    if (tiling_) {
+        return encodeTiled(colors, width, height, reuseBuffer);
+    }
+
+    reuseBuffer = codec_->encodeToBuffer(colors, width, height);
+
+    if (reuseBuffer.empty()) {
+        lastError_ = "Encoding failed";
+        return false;
+    }
+    lastError_.clear();
+    return true;
 }
 
 ofxGlicResult ofxGlicCodec::decode(const std::string& inputPath) {
-    ofxGlicResult result;
+    // Tiled files are decoded straight from the mapping; plain glic files
+    // are read by glic itself, which needs no extra copy either
+    ofxGlicMappedFile file;
+    if (file.open(inputPath) && ofxGlic::isTiledStream(file.data(), file.size())) {
+        return decodeFromBuffer(file.data(), file.size());
+    }
+    file.close();
 
+    ofxGlicResult result;
     auto glicResult = codec_->decode(inputPath);
 
     if (glicResult.success) {
@@ -123,32 +339,573 @@ ofxGlicResult ofxGlicCodec::decode(const std::string& inputPath) {
 }
 
 ofxGlicResult ofxGlicCodec::decodeFromBuffer(const std::vector<uint8_t>& buffer) {
+    ofxGlicWorkspace::Scope scope(workspace());
     ofxGlicResult result;
+    std::vector<glic::Color>& colors = workspace().acquireColors(0);
+    int width, height;
+
+    if (decodeColors(buffer.data(), buffer.size(), &buffer, colors, width, height)) {
+        result.success = true;
+        toOfImage(colors, width, height, result.image);
+    } else {
+        result.error = lastError_;
+    }
+    return result;
+}
 
-    auto glicResult = codec_->decodeFromBuffer(buffer);
+ofxGlicResult ofxGlicCodec::decodeFromBuffer(const uint8_t* data, size_t size) {
+    ofxGlicWorkspace::Scope scope(workspace());
+    ofxGlicResult result;
+    std::vector<glic::Color>& colors = workspace().acquireColors(0);
+    int width, height;
 
-    if (glicResult.success) {
+    if (decodeColors(data, size, nullptr, colors, width, height)) {
         result.success = true;
-        toOfImage(glicResult.pixels, glicResult.width, glicResult.height, result.image);
+        toOfImage(colors, width, height, result.image);
     } else {
-        result.success = false;
-        result.error = glicResult.error;
+        result.error = lastError_;
+    }
+    return result;
+}
+
+ofxGlicResult ofxGlicCodec::decodeFromStream(std::istream& stream) {
+    ofxGlicWorkspace::Scope scope(workspace());
+    std::vector<uint8_t>& bytes = workspace().acquireBytes();
+
+    if (!readStream(stream, bytes)) {
+        ofxGlicResult result;
+        result.error = "Failed to read stream";
+        lastError_ = result.error;
+        return result;
     }
+    return decodeFromBuffer(bytes);
+}
+
+bool ofxGlicCodec::decodeInto(const std::vector<uint8_t>& buffer, ofPixels& pixels) {
+    ofxGlicWorkspace::Scope scope(workspace());
+    std::vector<glic::Color>& colors = workspace().acquireColors(0);
+    int width, height;
+
+    if (!decodeColors(buffer.data(), buffer.size(), &buffer, colors, width, height)) return false;
+    ofxGlic::toOfPixels(colors.data(), width, height, pixels);
+    lastError_.clear();
+    return true;
+}
+
+bool ofxGlicCodec::decodeInto(const uint8_t* data, size_t size, ofPixels& pixels) {
+    ofxGlicWorkspace::Scope scope(workspace());
+    std::vector<glic::Color>& colors = workspace().acquireColors(0);
+    int width, height;
+
+    if (!decodeColors(data, size, nullptr, colors, width, height)) return false;
+    ofxGlic::toOfPixels(colors.data(), width, height, pixels);
+    lastError_.clear();
+    return true;
+}
+
+bool ofxGlicCodec::decodeColors(const uint8_t* data, size_t size, const std::vector<uint8_t>* buffer,
+                                std::vector<glic::Color>& colors, int& width, int& height) {
+    // Tiled streams are parsed in place; only one tile at a time is copied per lane
+    if (ofxGlic::isTiledStream(data, size)) {
+        return decodeTiled(data, size, colors, width, height);
+    }
+
+    // glic parses plain streams from a vector only; the workspace keeps one
+    // so steady-state decoding does not allocate here
+    if (!buffer) {
+        std::vector<uint8_t>& bytes = workspace().acquireBytes();
+        bytes.assign(data, data + size);
+        buffer = &bytes;
+    }
+
+    auto glicResult = codec_->decodeFromBuffer(*buffer);
+    if (!glicResult.success) {
+        lastError_ = glicResult.error;
+        return false;
+    }
+
+    width = glicResult.width;
+    height = glicResult.height;
+    colors.swap(glicResult.pixels);
+    return true;
+}
 
+ofxGlicResult ofxGlicCodec::decodeRegion(const std::vector<uint8_t>& buffer, const ofRectangle& region) {
+    ofxGlicWorkspace::Scope scope(workspace());
+    ofxGlicResult result;
+    std::vector<glic::Color>& colors = workspace().acquireColors(0);
+    int width, height;
+
+    if (decodeRegionColors(buffer.data(), buffer.size(), &buffer, region, colors, width, height)) {
+        result.success = true;
+        toOfImage(colors, width, height, result.image);
+    } else {
+        result.error = lastError_;
+    }
     return result;
 }
 
+bool ofxGlicCodec::decodeRegionInto(const uint8_t* data, size_t size, const ofRectangle& region, ofPixels& pixels) {
+    ofxGlicWorkspace::Scope scope(workspace());
+    std::vector<glic::Color>& colors = workspace().acquireColors(0);
+    int width, height;
+
+    if (!decodeRegionColors(data, size, nullptr, region, colors, width, height)) return false;
+    ofxGlic::toOfPixels(colors.data(), width, height, pixels);
+    lastError_.clear();
+    return true;
+}
+
+bool ofxGlicCodec::decodeRegionColors(const uint8_t* data, size_t size, const std::vector<uint8_t>* buffer,
+                                      const ofRectangle& region, std::vector<glic::Color>& colors,
+                                      int& width, int& height) {
+    if (ofxGlic::isTiledStream(data, size)) {
+        return decodeTiled(data, size, colors, width, height, &region);
+    }
+
+    // A plain glic stream is one quadtree over the whole frame, so it is
+    // decoded in full and cropped
+    std::vector<glic::Color>& full = workspace().acquireColors(0);
+    int fullWidth, fullHeight;
+    if (!decodeColors(data, size, buffer, full, fullWidth, fullHeight)) return false;
+
+    int x, y, x1, y1;
+    if (!ofxGlic::clipRegion(region, fullWidth, fullHeight, x, y, x1, y1)) {
+        lastError_ = "Region does not overlap the image";
+        return false;
+    }
+    width = x1 - x;
+    height = y1 - y;
+
+    colors.resize(size_t(width) * height);
+    for (int row = 0; row < height; row++) {
+        std::memcpy(&colors[size_t(row) * width], &full[size_t(y + row) * fullWidth + x], width * sizeof(glic::Color));
+    }
+    return true;
+}
+
+bool ofxGlicCodec::glitch(const ofPixels& source, ofPixels& out) {
+    // glic::GlicCodec only exposes the bitstream round trip, so the
+    // intermediate buffer stays but comes from the workspace
+    ofxGlicWorkspace::Scope scope(workspace());
+    if (streamMode_) {
+        sourceView_.set(source, workspace().acquireColors(0));
+        return glitchStream(sourceView_.data(), sourceView_.getWidth(), sourceView_.getHeight(), out);
+    }
+    if (channelParallel_ && !tiling_) {
+        sourceView_.set(source, workspace().acquireColors(0));
+        return glitchChannels(sourceView_.data(), sourceView_.getWidth(), sourceView_.getHeight(), out);
+    }
+    std::vector<uint8_t>& bitstream = workspace().acquireBytes();
+    return encodeFrom(source, bitstream) && decodeInto(bitstream, out);
+}
+
+bool ofxGlicCodec::glitch(const glic::Color* colors, int width, int height, ofPixels& out) {
+    if (streamMode_) {
+        return glitchStream(colors, width, height, out);
+    }
+    if (channelParallel_ && !tiling_) {
+        return glitchChannels(colors, width, height, out);
+    }
+    ofxGlicWorkspace::Scope scope(workspace());
+    std::vector<uint8_t>& bitstream = workspace().acquireBytes();
+    return encodeFrom(colors, width, height, bitstream) && decodeInto(bitstream, out);
+}
+
+bool ofxGlicCodec::glitchMulti(const ofPixels& source, const std::vector<ofxGlicPreset>& presets,
+                               std::vector<ofPixels>& outs) {
+    outs.resize(presets.size());
+    if (presets.empty()) return true;
+
+    // Presets with equal configs form one group, glitched once
+    std::vector<std::vector<size_t>> groups;
+    for (size_t i = 0; i < presets.size(); i++) {
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const std::vector<size_t>& g) {
+            return ofxGlic::configEquals(presets[g.front()].codecConfig, presets[i].codecConfig);
+        });
+        if (group == groups.end()) {
+            groups.push_back({i});
+        } else {
+            group->push_back(i);
+        }
+    }
+
+    ofxGlicWorkspace::Scope scope(workspace());
+    sourceView_.set(source, workspace().acquireColors(0));
+    const glic::Color* colors = sourceView_.data();
+    int width = sourceView_.getWidth();
+    int height = sourceView_.getHeight();
+
+    ofxGlicThreadPool& pool = ofxGlicThreadPool::shared();
+    size_t lanes = std::min(groups.size(), pool.getNumThreads() + 1);
+    if (numThreads_ > 0) lanes = std::min(lanes, numThreads_);
+    while (multiLanes_.size() < lanes) {
+        multiLanes_.push_back(std::make_unique<ofxGlicCodec>());
+    }
+
+    std::vector<std::shared_ptr<const ofxGlicEffectChain>> chains(presets.size());
+    for (size_t i = 0; i < presets.size(); i++) {
+        chains[i] = ofxGlicEffectChain::get(presets[i].effects);
+    }
+
+    // Each lane codec keeps its config cache, so repeating the same presets
+    // every frame configures nothing
+    std::atomic<size_t> nextGroup{0};
+    std::mutex errorMutex;
+    std::string error;
+    pool.parallelFor(lanes, [&](size_t lane) {
+        ofxGlicCodec& codec = *multiLanes_[lane];
+        codec.setTiling(tiling_, tileSize_);
+        codec.setChannelParallel(channelParallel_);
+        codec.setColorLut(colorLut_);
+        codec.setNumThreads(numThreads_);
+
+        size_t g;
+        while ((g = nextGroup.fetch_add(1)) < groups.size()) {
+            const std::vector<size_t>& group = groups[g];
+            ofPixels& first = outs[group.front()];
+            codec.setConfig(presets[group.front()].codecConfig);
+            if (!codec.glitch(colors, width, height, first)) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (error.empty()) error = presets[group.front()].name + ": " + codec.getLastError();
+                for (size_t i : group) outs[i].clear();
+                continue;
+            }
+
+            // Later presets copy the result before the first one's effects change it
+            for (size_t k = group.size(); k-- > 0;) {
+                size_t i = group[k];
+                if (k > 0) outs[i] = first;
+                chains[i]->apply(outs[i], codec.getWorkspace());
+            }
+        }
+    }, lanes);
+
+    if (!error.empty()) {
+        lastError_ = error;
+        return false;
+    }
+    return true;
+}
+
+std::vector<ofPixels> ofxGlicCodec::glitchMulti(const ofPixels& source, const std::vector<ofxGlicPreset>& presets) {
+    std::vector<ofPixels> outs;
+    glitchMulti(source, presets, outs);
+    return outs;
+}
+
+void ofxGlicCodec::setStreamMode(bool enabled, float threshold) {
+    streamMode_ = enabled;
+    streamThreshold_ = std::max(0.0f, threshold);
+    if (!enabled) {
+        streamValid_ = false;
+        streamReference_ = std::vector<glic::Color>();
+        streamDecoded_ = std::vector<glic::Color>();
+    }
+}
+
+bool ofxGlicCodec::glitchStream(const glic::Color* colors, int width, int height, ofPixels& out) {
+    ofxGlicTileLayout layout;
+    layout.width = width;
+    layout.height = height;
+    layout.tileWidth = tiling_ ? std::min(tileSize_, width) : width;
+    layout.tileHeight = tiling_ ? std::min(tileSize_, height) : height;
+
+    int numTiles = layout.getNumTiles();
+    if (numTiles == 0) {
+        lastError_ = "Encoding failed";
+        return false;
+    }
+
+    // Start over when nothing from the previous frame can be reused
+    bool restart = !streamValid_ || layout.width != streamLayout_.width || layout.height != streamLayout_.height ||
+                   layout.tileWidth != streamLayout_.tileWidth || layout.tileHeight != streamLayout_.tileHeight ||
+                   !ofxGlic::configEquals(config_, streamConfig_);
+    if (restart) {
+        size_t count = size_t(width) * height;
+        streamReference_.assign(colors, colors + count);
+        streamDecoded_.resize(count);
+        streamLayout_ = layout;
+        streamConfig_ = config_;
+    }
+    streamValid_ = false;
+
+    std::atomic<int> reused{0};
+    std::mutex errorMutex;
+    std::string error;
+
+    forEachTile(numTiles, [&](TileLane& lane, int tile) {
+        int x, y, w, h;
+        layout.getTileBounds(tile, x, y, w, h);
+        if (!restart && tileMatches(colors, streamReference_.data(), width, x, y, w, h, streamThreshold_)) {
+            reused++;
+            return;
+        }
+
+        lane.colors.resize(size_t(w) * h);
+        for (int row = 0; row < h; row++) {
+            std::memcpy(&lane.colors[size_t(row) * w], colors + size_t(y + row) * width + x, w * sizeof(glic::Color));
+        }
+
+        lane.codec.setConfig(config_);
+        lane.bytes = lane.codec.encodeToBuffer(lane.colors.data(), w, h);
+        auto glicResult = lane.codec.decodeFromBuffer(lane.bytes);
+        if (!glicResult.success || glicResult.width != w || glicResult.height != h ||
+            glicResult.pixels.size() < size_t(w) * h) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (error.empty()) {
+                error = "Tile " + std::to_string(tile) + ": " +
+                        (glicResult.success ? std::string("size does not match the tile") : glicResult.error);
+            }
+            return;
+        }
+
+        // The reference only moves when a tile is encoded, so slow drift
+        // still crosses the threshold eventually
+        for (int row = 0; row < h; row++) {
+            size_t offset = size_t(y + row) * width + x;
+            std::memcpy(&streamDecoded_[offset], &glicResult.pixels[size_t(row) * w], w * sizeof(glic::Color));
+            std::memcpy(&streamReference_[offset], colors + offset, w * sizeof(glic::Color));
+        }
+    });
+
+    if (!error.empty()) {
+        lastError_ = error;
+        return false;
+    }
+
+    streamValid_ = true;
+    streamTilesReused_ = reused;
+    streamTilesEncoded_ = numTiles - reused;
+    ofxGlic::toOfPixels(streamDecoded_.data(), width, height, out);
+    lastError_.clear();
+    return true;
+}
+
+bool ofxGlicCodec::glitchChannels(const glic::Color* colors, int width, int height, ofPixels& out) {
+    size_t count = size_t(width) * height;
+    if (count == 0) {
+        lastError_ = "Encoding failed";
+        return false;
+    }
+
+    ofxGlicThreadPool& pool = ofxGlicThreadPool::shared();
+    size_t threads = pool.getNumThreads() + 1;
+    if (numThreads_ > 0) threads = std::min(threads, numThreads_);
+
+    // Color space conversion runs once for all three channels, in row bands
+    ofxGlicWorkspace::Scope scope(workspace());
+    std::vector<glic::Color>& planes = workspace().acquireColors(count);
+    const glic::ColorSpace space = config_.colorSpace;
+    std::shared_ptr<const ofxGlicColorLut> toSpace, fromSpace;
+    if (colorLut_ && space != glic::ColorSpace::RGB) {
+        toSpace = ofxGlicColorLut::shared(space, ofxGlicColorLut::TO_SPACE);
+        fromSpace = ofxGlicColorLut::shared(space, ofxGlicColorLut::FROM_SPACE);
+    }
+    size_t bands = std::min(size_t(height), threads);
+    pool.parallelFor(bands, [&](size_t band) {
+        size_t begin = count * band / bands, end = count * (band + 1) / bands;
+        if (toSpace) {
+            toSpace->convert(colors + begin, planes.data() + begin, end - begin);
+            return;
+        }
+        for (size_t i = begin; i < end; i++) {
+            planes[i] = glic::toColorspace(colors[i], space);
+        }
+    }, bands);
+
+    while (channelLanes_.size() < 3) {
+        channelLanes_.push_back(std::make_unique<ChannelLane>());
+    }
+
+    // Channel c always runs on lane c, so the result does not depend on
+    // which thread picks it up
+    std::mutex errorMutex;
+    std::string error;
+    pool.parallelFor(3, [&](size_t channel) {
+        ChannelLane& lane = *channelLanes_[channel];
+        glic::CodecConfig config = makeChannelConfig(config_, int(channel));
+        if (!lane.configured || !ofxGlic::configEquals(lane.config, config)) {
+            lane.codec.setConfig(config);
+            lane.config = config;
+            lane.configured = true;
+        }
+
+        lane.bytes = lane.codec.encodeToBuffer(planes.data(), width, height);
+        auto glicResult = lane.codec.decodeFromBuffer(lane.bytes);
+        if (!glicResult.success || glicResult.width != width || glicResult.height != height ||
+            glicResult.pixels.size() < count) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (error.empty()) {
+                error = "Channel " + std::to_string(channel) + ": " +
+                        (glicResult.success ? std::string("size does not match the frame") : glicResult.error);
+            }
+            return;
+        }
+        lane.decoded.swap(glicResult.pixels);
+    }, std::min<size_t>(3, threads));
+
+    if (!error.empty()) {
+        lastError_ = error;
+        return false;
+    }
+
+    // Each lane contributes its own channel; alpha comes from the first
+    const glic::Color* c0 = channelLanes_[0]->decoded.data();
+    const glic::Color* c1 = channelLanes_[1]->decoded.data();
+    const glic::Color* c2 = channelLanes_[2]->decoded.data();
+    pool.parallelFor(bands, [&](size_t band) {
+        size_t begin = count * band / bands, end = count * (band + 1) / bands;
+        for (size_t i = begin; i < end; i++) {
+            glic::Color merged =
+                glic::makeColor(glic::getR(c0[i]), glic::getG(c1[i]), glic::getB(c2[i]), glic::getA(c0[i]));
+            planes[i] = fromSpace ? fromSpace->convert(merged) : glic::fromColorspace(merged, space);
+        }
+    }, bands);
+
+    ofxGlic::toOfPixels(planes.data(), width, height, out);
+    lastError_.clear();
+    return true;
+}
+
+void ofxGlicCodec::forEachTile(int numTiles, const std::function<void(TileLane&, int)>& fn) {
+    ofxGlicThreadPool& pool = ofxGlicThreadPool::shared();
+    size_t lanes = std::min(size_t(numTiles), pool.getNumThreads() + 1);
+    if (numThreads_ > 0) lanes = std::min(lanes, numThreads_);
+
+    while (tileLanes_.size() < lanes) {
+        tileLanes_.push_back(std::make_unique<TileLane>());
+    }
+
+    // Each lane owns one codec and pulls tiles until none are left
+    std::atomic<int> nextTile{0};
+    pool.parallelFor(lanes, [&](size_t lane) {
+        int tile;
+        while ((tile = nextTile.fetch_add(1)) < numTiles) {
+            fn(*tileLanes_[lane], tile);
+        }
+    }, lanes);
+}
+
+bool ofxGlicCodec::encodeTiled(const glic::Color* colors, int width, int height, std::vector<uint8_t>& out) {
+    ofxGlicTileLayout layout;
+    layout.width = width;
+    layout.height = height;
+    layout.tileWidth = std::min(tileSize_, width);
+    layout.tileHeight = std::min(tileSize_, height);
+
+    int numTiles = layout.getNumTiles();
+    if (numTiles == 0) {
+        lastError_ = "Encoding failed";
+        return false;
+    }
+
+    tileStreams_.resize(numTiles);
+    std::atomic<bool> failed{false};
+
+    forEachTile(numTiles, [&](TileLane& lane, int tile) {
+        int x, y, w, h;
+        layout.getTileBounds(tile, x, y, w, h);
+
+        lane.colors.resize(size_t(w) * h);
+        for (int row = 0; row < h; row++) {
+            std::memcpy(&lane.colors[size_t(row) * w], colors + size_t(y + row) * width + x, w * sizeof(glic::Color));
+        }
+
+        // Reset the codec for every tile so its output does not depend on
+        // which tiles the lane encoded before
+        lane.codec.setConfig(config_);
+        tileStreams_[tile] = lane.codec.encodeToBuffer(lane.colors.data(), w, h);
+        if (tileStreams_[tile].empty()) failed = true;
+    });
+
+    if (failed) {
+        lastError_ = "Encoding failed";
+        return false;
+    }
+
+    ofxGlic::writeTiledStream(layout, tileStreams_, out);
+    lastError_.clear();
+    return true;
+}
+
+bool ofxGlicCodec::decodeTiled(const uint8_t* data, size_t size, std::vector<glic::Color>& colors,
+                               int& width, int& height, const ofRectangle* region) {
+    ofxGlicTileLayout layout;
+    if (!ofxGlic::readTiledStream(data, size, layout, tileRanges_, lastError_)) {
+        return false;
+    }
+
+    int rx = 0, ry = 0, rx1 = layout.width, ry1 = layout.height;
+    if (region && !ofxGlic::clipRegion(*region, layout.width, layout.height, rx, ry, rx1, ry1)) {
+        lastError_ = "Region does not overlap the image";
+        return false;
+    }
+    int rw = rx1 - rx, rh = ry1 - ry;
+
+    // Only the tiles overlapping the region are decoded
+    tileIndices_.clear();
+    for (int ty = ry / layout.tileHeight; ty <= (ry + rh - 1) / layout.tileHeight; ty++) {
+        for (int tx = rx / layout.tileWidth; tx <= (rx + rw - 1) / layout.tileWidth; tx++) {
+            tileIndices_.push_back(ty * layout.getNumTilesX() + tx);
+        }
+    }
+
+    colors.resize(size_t(rw) * rh);
+    std::mutex errorMutex;
+    std::string error;
+
+    forEachTile(int(tileIndices_.size()), [&](TileLane& lane, int index) {
+        int tile = tileIndices_[index];
+        const ofxGlicTileRange& range = tileRanges_[tile];
+        lane.bytes.assign(data + range.offset, data + range.offset + range.size);
+
+        lane.codec.setConfig(config_);
+        auto glicResult = lane.codec.decodeFromBuffer(lane.bytes);
+
+        int x, y, w, h;
+        layout.getTileBounds(tile, x, y, w, h);
+        if (!glicResult.success || glicResult.width != w || glicResult.height != h ||
+            glicResult.pixels.size() < size_t(w) * h) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (error.empty()) {
+                error = "Tile " + std::to_string(tile) + ": " +
+                        (glicResult.success ? std::string("size does not match the tile layout") : glicResult.error);
+            }
+            return;
+        }
+
+        // Copy the part of the tile inside the region
+        int x0 = std::max(x, rx), x1 = std::min(x + w, rx + rw);
+        int y0 = std::max(y, ry), y1 = std::min(y + h, ry + rh);
+        for (int row = y0; row < y1; row++) {
+            std::memcpy(&colors[size_t(row - ry) * rw + (x0 - rx)], &glicResult.pixels[size_t(row - y) * w + (x0 - x)],
+                        (x1 - x0) * sizeof(glic::Color));
+        }
+    });
+
+    if (!error.empty()) {
+        lastError_ = error;
+        return false;
+    }
+
+    width = rw;
+    height = rh;
+    return true;
+}
+
 bool ofxGlicCodec::encodeImage(const ofImage& source, const std::string& outputPath,
                                const glic::CodecConfig& config) {
-    ofxGlicCodec codec;
+    ofxGlicCodec& codec = getHelperPool().get();
     codec.setConfig(config);
     auto result = codec.encode(source, outputPath);
     return result.success;
 }
 
 ofxGlicResult ofxGlicCodec::decodeImage(const std::string& inputPath) {
-    ofxGlicCodec codec;
-    return codec.decode(inputPath);
+    // Same defaults as a freshly constructed codec
+    static const ofxGlicConfigSnapshot defaultConfig = ofxGlic::makeConfigSnapshot();
+    return getHelperPool().get(defaultConfig).decode(inputPath);
 }
 
 void ofxGlicCodec::setPostEffects(const std::vector<ofxGlicEffect>& effects) {
@@ -3,8 +3,16 @@
 #include "ofMain.h"
 #include "ofxGlicConfig.h"
 #include "ofxGlicEffects.h"
+#include "ofxGlicPixels.h"
+#include "ofxGlicPresets.h"
+#include "ofxGlicTiles.h"
+#include "ofxGlicWorkspace.h"
 #include <vector>
 #include <string>
+#include <functional>
+#include <istream>
+#include <list>
+#include <memory>
 
 // Forward declaration
 namespace glic {
@@ -28,10 +36,20 @@ public:
     ~ofxGlicCodec();
 
     // Configuration
+    // Setting a config equal to the current one does nothing. The glic codecs
+    // of recently used configs are kept, so switching back to one is free.
     void setConfig(const glic::CodecConfig& config);
+    void setConfig(const ofxGlicConfigSnapshot& config);
     glic::CodecConfig& getConfig();
     const glic::CodecConfig& getConfig() const;
 
+    // Number of configured glic codecs kept (default: enough for the built-in presets)
+    void setConfigCacheSize(size_t size);
+    size_t getConfigCacheSize() const { return configCacheSize_; }
+    // Config changes served from the cache / that configured a new glic codec
+    uint64_t getConfigCacheHits() const { return configCacheHits_; }
+    uint64_t getConfigCacheMisses() const { return configCacheMisses_; }
+
     // Set individual config values
     void setColorSpace(glic::ColorSpace cs);
     void setBorderColor(uint8_t r, uint8_t g, uint8_t b);
@@ -41,18 +59,132 @@ public:
     void setChannelConfig(int channel, const glic::ChannelConfig& config);
     glic::ChannelConfig& getChannelConfig(int channel);
 
+    // Tiled mode (off by default)
+    // Frames are split into tileSize x tileSize tiles that are encoded and
+    // decoded in parallel on ofxGlicThreadPool::shared(). Each tile is a
+    // separate glic stream, so block structure restarts at tile edges.
+    // Tiled streams record their tile layout and are recognised by every
+    // decode method whether or not tiling is enabled.
+    void setTiling(bool enabled, int tileSize = 512);
+    bool isTiling() const { return tiling_; }
+    int getTileSize() const { return tileSize_; }
+
+    // Most threads used for tiles, including the calling thread (0 = all)
+    // Also sets the post effects' thread count (see ofxGlicEffects::setNumThreads).
+    // Output does not depend on the thread count.
+    void setNumThreads(size_t numThreads) {
+        numThreads_ = numThreads;
+        postEffects_.setNumThreads(numThreads);
+    }
+    size_t getNumThreads() const { return numThreads_; }
+
+    // Per-channel mode (off by default)
+    // glitch() converts the frame to the config's color space once and runs
+    // the three channels as three glic codecs in parallel on
+    // ofxGlicThreadPool::shared(), then merges the planes. Each codec gets
+    // the frame in that color space with RGB selected, its own channel's
+    // settings and the cheapest settings on the other two. Unlike tiling,
+    // every channel keeps one quadtree over the whole frame. Output does not
+    // depend on the thread count. Tiling and stream mode take precedence,
+    // and the encode methods still write one glic stream.
+    void setChannelParallel(bool enabled) { channelParallel_ = enabled; }
+    bool isChannelParallel() const { return channelParallel_; }
+
+    // Color lookup tables (off by default)
+    // Per-channel mode then converts to and from the color space through the
+    // process-wide tables of ofxGlicColorLut instead of glic's per-pixel
+    // math, with identical output. The first frame in a color space builds
+    // its two tables (96 MB). Worth it for LAB, LUV, HCL, XYZ and the other
+    // nonlinear spaces; without per-channel mode glic converts inside its
+    // codec, and this has no effect.
+    void setColorLut(bool enabled) { colorLut_ = enabled; }
+    bool isColorLut() const { return colorLut_; }
+
+    // Stream mode for video and camera frames (off by default)
+    // glitch() compares each tile with the frame it was last encoded from,
+    // in 16x16 cells: a tile keeps its previous result instead of being
+    // encoded again when no cell's mean absolute difference per color
+    // channel exceeds threshold (0-255; alpha is ignored), so a small moving
+    // object still counts as a change. Saves work on mostly static scenes
+    // and keeps those areas from flickering. Uses the tiles of setTiling(),
+    // or the whole frame as one tile when tiling is off (then only frames
+    // with no changed cell are reused). A new frame size or config starts over.
+    void setStreamMode(bool enabled, float threshold = 1.0f);
+    bool isStreamMode() const { return streamMode_; }
+    float getStreamThreshold() const { return streamThreshold_; }
+    void resetStream() { streamValid_ = false; }
+    // Tiles reused / encoded by the last glitch() in stream mode
+    int getStreamTilesReused() const { return streamTilesReused_; }
+    int getStreamTilesEncoded() const { return streamTilesEncoded_; }
+
+    // Scratch memory for intermediate buffers (nullptr = the codec's own)
+    // A shared workspace must only be used from one thread at a time.
+    void setWorkspace(ofxGlicWorkspace* workspace);
+    ofxGlicWorkspace& getWorkspace() { return workspace(); }
+
     // Encoding - from ofImage
     ofxGlicResult encode(const ofImage& source, const std::string& outputPath);
 
     // Encoding - to memory buffer
     std::vector<uint8_t> encodeToBuffer(const ofImage& source);
 
+    // Encoding - from ofPixels into a caller-owned buffer (no ofImage, no GPU)
+    bool encodeFrom(const ofPixels& source, std::vector<uint8_t>& reuseBuffer);
+
+    // Encoding - from colors the caller already converted
+    bool encodeFrom(const glic::Color* colors, int width, int height, std::vector<uint8_t>& reuseBuffer);
+
     // Decoding - from file
+    // Tiled files are memory-mapped and decoded in place
     ofxGlicResult decode(const std::string& inputPath);
 
     // Decoding - from memory buffer
     ofxGlicResult decodeFromBuffer(const std::vector<uint8_t>& buffer);
 
+    // Decoding - from memory the caller owns (e.g. a mapped file)
+    // Tiled streams are parsed in place; plain glic streams are copied once,
+    // since glic only parses from a vector
+    ofxGlicResult decodeFromBuffer(const uint8_t* data, size_t size);
+
+    // Decoding - from the current position to the end of a stream
+    ofxGlicResult decodeFromStream(std::istream& stream);
+
+    // Decoding - into caller-owned ofPixels (no ofImage, no GPU)
+    // Keeps the pixels' allocation and format when the size matches,
+    // otherwise allocates RGBA
+    bool decodeInto(const std::vector<uint8_t>& buffer, ofPixels& pixels);
+    bool decodeInto(const uint8_t* data, size_t size, ofPixels& pixels);
+
+    // Decoding - only the pixels inside region (clipped to the image)
+    // Tiled streams decode just the tiles overlapping the region; a plain
+    // glic stream is one quadtree over the frame, so it is decoded in full
+    // and cropped.
+    ofxGlicResult decodeRegion(const std::vector<uint8_t>& buffer, const ofRectangle& region);
+    bool decodeRegionInto(const uint8_t* data, size_t size, const ofRectangle& region, ofPixels& pixels);
+
+    // Encode + decode in one call: returns the glitched reconstruction of source
+    // Runs encodeFrom() and decodeInto() through a workspace buffer, so the
+    // output is identical to that pair. This is not a fused codec path: glic
+    // still writes and parses the full bitstream, because glic::GlicCodec
+    // has no call that returns the reconstruction without serializing it.
+    // The call only saves the ofImage and texture work of encodeToBuffer()
+    // and decodeFromBuffer().
+    bool glitch(const ofPixels& source, ofPixels& out);
+    bool glitch(const glic::Color* colors, int width, int height, ofPixels& out);
+
+    // Glitch one frame with several presets: outs[i] is source glitched with
+    // presets[i] and its effects. The source is converted to glic colors once,
+    // presets with equal codec configs share one encode and decode, and
+    // distinct configs run in parallel on ofxGlicThreadPool::shared(). glic
+    // runs its color space conversion and segmentation inside encode, so
+    // those are only shared between presets whose configs are equal.
+    // Tiling and the thread limit apply to every preset; stream mode does not.
+    bool glitchMulti(const ofPixels& source, const std::vector<ofxGlicPreset>& presets, std::vector<ofPixels>& outs);
+    std::vector<ofPixels> glitchMulti(const ofPixels& source, const std::vector<ofxGlicPreset>& presets);
+
+    // Error message of the last failed encodeFrom/decodeInto/glitch
+    const std::string& getLastError() const { return lastError_; }
+
     // Post-processing effects
     void setPostEffects(const std::vector<ofxGlicEffect>& effects);
     void addPostEffect(const ofxGlicEffect& effect);
@@ -64,6 +196,8 @@ public:
     void applyEffects(ofImage& image);
 
     // Quick encode/decode (static methods)
+    // Run on a per-thread codec that only these helpers use, so they always
+    // write and read plain glic streams
     static bool encodeImage(const ofImage& source, const std::string& outputPath,
                             const glic::CodecConfig& config = glic::CodecConfig());
     static ofxGlicResult decodeImage(const std::string& inputPath);
@@ -73,8 +207,69 @@ public:
     static void toOfImage(const std::vector<glic::Color>& colors, int width, int height, ofImage& img);
 
 private:
-    std::unique_ptr<glic::GlicCodec> codec_;
+    // Codec and scratch buffers owned by one tile worker
+    struct TileLane;
+    // Codec that carries one channel in per-channel mode
+    struct ChannelLane;
+
+    // glic codec configured for one config
+    struct ConfigCacheEntry {
+        glic::CodecConfig config;
+        uint64_t hash = 0;
+        std::unique_ptr<glic::GlicCodec> codec;
+    };
+
+    // Make codec_ the glic codec for config_
+    void applyConfig();
+
+    bool encodeTiled(const glic::Color* colors, int width, int height, std::vector<uint8_t>& out);
+    // Decode a plain or tiled stream; buffer is the same bytes as a vector when
+    // the caller has one, which saves a copy for plain streams
+    bool decodeColors(const uint8_t* data, size_t size, const std::vector<uint8_t>* buffer,
+                      std::vector<glic::Color>& colors, int& width, int& height);
+    // region limits decoding to the overlapping tiles (nullptr = whole frame)
+    bool decodeTiled(const uint8_t* data, size_t size, std::vector<glic::Color>& colors, int& width, int& height,
+                     const ofRectangle* region = nullptr);
+    bool decodeRegionColors(const uint8_t* data, size_t size, const std::vector<uint8_t>* buffer,
+                            const ofRectangle& region, std::vector<glic::Color>& colors, int& width, int& height);
+    bool glitchStream(const glic::Color* colors, int width, int height, ofPixels& out);
+    bool glitchChannels(const glic::Color* colors, int width, int height, ofPixels& out);
+    void forEachTile(int numTiles, const std::function<void(TileLane&, int)>& fn);
+    ofxGlicWorkspace& workspace() { return externalWorkspace_ ? *externalWorkspace_ : ownWorkspace_; }
+
+    glic::GlicCodec* codec_ = nullptr;  // Front of configCache_
     glic::CodecConfig config_;
+    std::list<ConfigCacheEntry> configCache_;  // Most recently used first
+    size_t configCacheSize_ = 10;
+    uint64_t configCacheHits_ = 0;
+    uint64_t configCacheMisses_ = 0;
+    ofxGlicColorView sourceView_;
+    ofxGlicWorkspace ownWorkspace_;
+    ofxGlicWorkspace* externalWorkspace_ = nullptr;
+    std::string lastError_;
     ofxGlicEffects postEffects_;
     bool applyPostEffects_ = true;
+
+    bool tiling_ = false;
+    int tileSize_ = 512;
+    size_t numThreads_ = 0;
+    std::vector<std::unique_ptr<TileLane>> tileLanes_;
+    std::vector<std::vector<uint8_t>> tileStreams_;
+    std::vector<ofxGlicTileRange> tileRanges_;
+    std::vector<int> tileIndices_;  // Tiles being decoded
+    std::vector<std::unique_ptr<ofxGlicCodec>> multiLanes_;  // glitchMulti() codecs, one per parallel config
+
+    bool channelParallel_ = false;
+    std::vector<std::unique_ptr<ChannelLane>> channelLanes_;  // One per channel
+    bool colorLut_ = false;
+
+    bool streamMode_ = false;
+    float streamThreshold_ = 1.0f;
+    bool streamValid_ = false;  // The fields below describe the previous frame
+    ofxGlicTileLayout streamLayout_;
+    glic::CodecConfig streamConfig_;
+    std::vector<glic::Color> streamReference_;  // Source each tile was last encoded from
+    std::vector<glic::Color> streamDecoded_;    // Last result of each tile
+    int streamTilesReused_ = 0;
+    int streamTilesEncoded_ = 0;
 };
@@ -0,0 +1,124 @@
+#include "ofxGlicCodecPool.h"
+#include <unordered_map>
+
+namespace {
+    std::atomic<uint64_t> nextPoolId{1};
+
+    // Pools that still exist, so an exiting thread only releases slots of
+    // live pools. Never destroyed: threads may exit during static destruction.
+    struct LivePools {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, ofxGlicCodecPool*> pools;
+    };
+
+    LivePools& getLivePools() {
+        static LivePools* livePools = new LivePools();
+        return *livePools;
+    }
+}
+
+// Per-thread lookup: pool id -> this thread's slot in that pool
+struct ofxGlicCodecPool::ThreadSlots {
+    struct Entry {
+        uint64_t poolId;
+        Slot* slot;
+    };
+    std::vector<Entry> entries;
+
+    ~ThreadSlots() {
+        LivePools& live = getLivePools();
+        std::lock_guard<std::mutex> lock(live.mutex);
+        for (const Entry& entry : entries) {
+            auto it = live.pools.find(entry.poolId);
+            if (it != live.pools.end()) {
+                it->second->releaseSlot(entry.slot);
+            }
+        }
+    }
+};
+
+thread_local ofxGlicCodecPool::ThreadSlots ofxGlicCodecPool::threadSlots_;
+
+ofxGlicCodecPool::ofxGlicCodecPool() : id_(nextPoolId.fetch_add(1)) {
+    LivePools& live = getLivePools();
+    std::lock_guard<std::mutex> lock(live.mutex);
+    live.pools[id_] = this;
+}
+
+ofxGlicCodecPool::~ofxGlicCodecPool() {
+    LivePools& live = getLivePools();
+    std::lock_guard<std::mutex> lock(live.mutex);
+    live.pools.erase(id_);
+}
+
+ofxGlicCodecPool& ofxGlicCodecPool::shared() {
+    static ofxGlicCodecPool pool;
+    return pool;
+}
+
+ofxGlicCodecPool::Slot& ofxGlicCodecPool::getSlot() {
+    for (const auto& entry : threadSlots_.entries) {
+        if (entry.poolId == id_) {
+            return *entry.slot;
+        }
+    }
+
+    // First use on this thread
+    auto slot = std::make_unique<Slot>();
+    Slot* ptr = slot.get();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slots_.push_back(std::move(slot));
+    }
+    threadSlots_.entries.push_back({id_, ptr});
+    return *ptr;
+}
+
+void ofxGlicCodecPool::releaseSlot(Slot* slot) {
+    std::unique_ptr<Slot> released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = slots_.begin(); it != slots_.end(); ++it) {
+            if (it->get() == slot) {
+                released = std::move(*it);
+                slots_.erase(it);
+                break;
+            }
+        }
+    }
+    // The codec is destroyed outside the pool lock
+}
+
+ofxGlicCodec& ofxGlicCodecPool::get() {
+    // The caller may change the config directly, so forget the snapshot
+    Slot& slot = getSlot();
+    slot.config.reset();
+    return slot.codec;
+}
+
+ofxGlicCodec& ofxGlicCodecPool::get(const ofxGlicConfigSnapshot& config) {
+    Slot& slot = getSlot();
+    if (config && slot.config != config) {
+        slot.codec.setConfig(*config);
+        slot.config = config;
+    }
+    return slot.codec;
+}
+
+bool ofxGlicCodecPool::glitch(const ofxGlicConfigSnapshot& config, const ofPixels& source, ofPixels& out) {
+    return get(config).glitch(source, out);
+}
+
+bool ofxGlicCodecPool::encodeFrom(const ofxGlicConfigSnapshot& config, const ofPixels& source,
+                                  std::vector<uint8_t>& buffer) {
+    return get(config).encodeFrom(source, buffer);
+}
+
+bool ofxGlicCodecPool::decodeInto(const std::vector<uint8_t>& buffer, ofPixels& pixels) {
+    return get().decodeInto(buffer, pixels);
+}
+
+size_t ofxGlicCodecPool::getNumCodecs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slots_.size();
+}
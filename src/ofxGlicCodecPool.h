@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ofxGlicCodec.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Hands out one ofxGlicCodec per thread
+// Each thread gets its own codec on first use and keeps it, with its scratch
+// buffers, until the thread exits or the pool is destroyed, so short-lived
+// threads do not leave codecs behind. Lookups after the first take no lock.
+// Codecs are configured from ofxGlicConfigSnapshot; passing the same snapshot
+// again does not touch the codec config.
+class ofxGlicCodecPool {
+public:
+    ofxGlicCodecPool();
+    ~ofxGlicCodecPool();
+
+    ofxGlicCodecPool(const ofxGlicCodecPool&) = delete;
+    ofxGlicCodecPool& operator=(const ofxGlicCodecPool&) = delete;
+
+    // Process-wide pool
+    static ofxGlicCodecPool& shared();
+
+    // The calling thread's codec; only use it on this thread
+    // Its config is whatever the thread last set.
+    ofxGlicCodec& get();
+
+    // The calling thread's codec, configured with config
+    ofxGlicCodec& get(const ofxGlicConfigSnapshot& config);
+
+    // Shortcuts running on the calling thread's codec
+    bool glitch(const ofxGlicConfigSnapshot& config, const ofPixels& source, ofPixels& out);
+    bool encodeFrom(const ofxGlicConfigSnapshot& config, const ofPixels& source, std::vector<uint8_t>& buffer);
+    bool decodeInto(const std::vector<uint8_t>& buffer, ofPixels& pixels);
+
+    // Number of live threads that have a codec
+    size_t getNumCodecs() const;
+
+private:
+    struct Slot {
+        ofxGlicCodec codec;
+        ofxGlicConfigSnapshot config;  // Snapshot the codec was last configured with
+    };
+    struct ThreadSlots;  // A thread's slots in every pool; frees them when the thread exits
+
+    Slot& getSlot();
+    // Remove a slot when its thread exits
+    void releaseSlot(Slot* slot);
+
+    static thread_local ThreadSlots threadSlots_;
+
+    const uint64_t id_;  // Never reused, so stale thread-local entries cannot match a new pool
+    std::vector<std::unique_ptr<Slot>> slots_;
+    mutable std::mutex mutex_;
+};
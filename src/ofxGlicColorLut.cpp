@@ -0,0 +1,62 @@
+#include "ofxGlicColorLut.h"
+#include "ofxGlicThreadPool.h"
+#include "glic/colorspaces.hpp"
+#include <mutex>
+
+namespace {
+    const int numColorSpaces = int(glic::ColorSpace::YUV) + 1;
+
+    struct SharedTables {
+        std::mutex mutex[numColorSpaces][2];  // One per table, so building one does not hold up the others
+        std::shared_ptr<const ofxGlicColorLut> tables[numColorSpaces][2];
+    };
+
+    // Never destroyed: codecs in static objects may look tables up during exit
+    SharedTables& getSharedTables() {
+        static SharedTables* tables = new SharedTables();
+        return *tables;
+    }
+}
+
+ofxGlicColorLut::ofxGlicColorLut(glic::ColorSpace space, Direction direction)
+    : space_(space), direction_(direction) {
+    table_.resize((size_t(1) << 24) * 3);
+
+    // One task per red value; each writes its own 64K entries
+    ofxGlicThreadPool::shared().parallelFor(256, [&](size_t r) {
+        uint8_t* entry = &table_[(r << 16) * 3];
+        for (int g = 0; g < 256; g++) {
+            for (int b = 0; b < 256; b++, entry += 3) {
+                glic::Color color = glic::makeColor(uint8_t(r), uint8_t(g), uint8_t(b));
+                glic::Color result = direction == TO_SPACE ? glic::toColorspace(color, space)
+                                                           : glic::fromColorspace(color, space);
+                entry[0] = glic::getR(result);
+                entry[1] = glic::getG(result);
+                entry[2] = glic::getB(result);
+            }
+        }
+    });
+}
+
+std::shared_ptr<const ofxGlicColorLut> ofxGlicColorLut::shared(glic::ColorSpace space, Direction direction) {
+    int index = int(space);
+    if (index < 0 || index >= numColorSpaces) {
+        return std::make_shared<const ofxGlicColorLut>(space, direction);
+    }
+
+    SharedTables& shared = getSharedTables();
+    std::lock_guard<std::mutex> lock(shared.mutex[index][direction]);
+    std::shared_ptr<const ofxGlicColorLut>& table = shared.tables[index][direction];
+    if (!table) table = std::make_shared<const ofxGlicColorLut>(space, direction);
+    return table;
+}
+
+void ofxGlicColorLut::releaseShared() {
+    SharedTables& shared = getSharedTables();
+    for (int i = 0; i < numColorSpaces; i++) {
+        for (int direction = 0; direction < 2; direction++) {
+            std::lock_guard<std::mutex> lock(shared.mutex[i][direction]);
+            shared.tables[i][direction].reset();
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ofxGlicConfig.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Exact lookup table for one of glic's color space conversions
+// Holds glic::toColorspace's (or glic::fromColorspace's) result for each of
+// the 2^24 8-bit RGB triples, 3 bytes each: 48 MB per table. Alpha is passed
+// through, as glic's conversions do. A lookup replaces the per-pixel math of
+// LAB, LUV, HCL, XYZ, HSB, HWB and the like with one scattered load, which
+// wins for those but not for the linear spaces; example_benchmark measures
+// both for every color space. Building a table runs every triple through glic
+// once, in parallel on ofxGlicThreadPool::shared().
+class ofxGlicColorLut {
+public:
+    enum Direction {
+        TO_SPACE,    // glic::toColorspace
+        FROM_SPACE   // glic::fromColorspace
+    };
+
+    // Build a table of its own
+    ofxGlicColorLut(glic::ColorSpace space, Direction direction);
+
+    ofxGlicColorLut(const ofxGlicColorLut&) = delete;
+    ofxGlicColorLut& operator=(const ofxGlicColorLut&) = delete;
+
+    // Process-wide table, built by the first call for its space and
+    // direction; later calls return it without building
+    static std::shared_ptr<const ofxGlicColorLut> shared(glic::ColorSpace space, Direction direction);
+
+    // Drop the process-wide tables; ones still held elsewhere live on
+    static void releaseShared();
+
+    glic::ColorSpace getColorSpace() const { return space_; }
+    Direction getDirection() const { return direction_; }
+
+    glic::Color convert(glic::Color color) const {
+        const uint8_t* entry = &table_[(size_t(glic::getR(color)) << 16 | size_t(glic::getG(color)) << 8 |
+                                        glic::getB(color)) * 3];
+        return glic::makeColor(entry[0], entry[1], entry[2], glic::getA(color));
+    }
+
+    // out may be in
+    void convert(const glic::Color* in, glic::Color* out, size_t count) const {
+        for (size_t i = 0; i < count; i++) out[i] = convert(in[i]);
+    }
+
+    size_t getMemoryBytes() const { return table_.capacity(); }
+
+private:
+    glic::ColorSpace space_;
+    Direction direction_;
+    std::vector<uint8_t> table_;  // R, G, B of the result, indexed by the input's RGB
+};
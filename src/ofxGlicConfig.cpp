@@ -0,0 +1,100 @@
+#include "ofxGlicConfig.h"
+#include <cstring>
+#include <type_traits>
+
+namespace {
+    // 64-bit FNV-1a over explicit little-endian field values, so padding and
+    // struct layout never affect the result
+    struct Hasher {
+        uint64_t value = 14695981039346656037ull;
+
+        void add(uint32_t v) {
+            for (int i = 0; i < 4; i++) {
+                value ^= (v >> (8 * i)) & 0xFF;
+                value *= 1099511628211ull;
+            }
+        }
+
+        void add(int v) { add(uint32_t(v)); }
+
+        void add(float v) {
+            if (v == 0.0f) v = 0.0f;  // -0 == +0, so they must hash alike
+            uint32_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            add(bits);
+        }
+
+        // Enums and integers hash as int, floating point as float
+        template<typename T>
+        void addField(T v) {
+            if constexpr (std::is_floating_point<T>::value) {
+                add(float(v));
+            } else {
+                add(int(v));
+            }
+        }
+    };
+}
+
+// The settings configEquals and configHash read, listed once so the two
+// always agree. They are every field of glic::ChannelConfig and
+// glic::CodecConfig in the glic version below; a field left out would make
+// different configs share codec and session cache entries, so check the
+// lists against glic's config.hpp before raising the version.
+#define OFXGLIC_CHANNEL_CONFIG_FIELDS(X) \
+    X(minBlockSize) \
+    X(maxBlockSize) \
+    X(segmentationPrecision) \
+    X(predictionMethod) \
+    X(quantizationValue) \
+    X(clampMethod) \
+    X(waveletType) \
+    X(transformCompress) \
+    X(transformScale) \
+    X(transformType) \
+    X(encodingMethod)
+
+#define OFXGLIC_CODEC_CONFIG_FIELDS(X) \
+    X(colorSpace) \
+    X(borderColorR) \
+    X(borderColorG) \
+    X(borderColorB)
+
+#if defined(GLIC_VERSION_MAJOR) && defined(GLIC_VERSION_MINOR)
+#if GLIC_VERSION_MAJOR != 1 || GLIC_VERSION_MINOR != 0
+#error "glic version changed: check OFXGLIC_CHANNEL_CONFIG_FIELDS and OFXGLIC_CODEC_CONFIG_FIELDS in ofxGlicConfig.cpp"
+#endif
+#endif
+
+namespace ofxGlic {
+
+bool configEquals(const glic::ChannelConfig& a, const glic::ChannelConfig& b) {
+#define OFXGLIC_EQUAL(field) if (!(a.field == b.field)) return false;
+    OFXGLIC_CHANNEL_CONFIG_FIELDS(OFXGLIC_EQUAL)
+#undef OFXGLIC_EQUAL
+    return true;
+}
+
+bool configEquals(const glic::CodecConfig& a, const glic::CodecConfig& b) {
+#define OFXGLIC_EQUAL(field) if (!(a.field == b.field)) return false;
+    OFXGLIC_CODEC_CONFIG_FIELDS(OFXGLIC_EQUAL)
+#undef OFXGLIC_EQUAL
+    return configEquals(a.channels[0], b.channels[0]) &&
+           configEquals(a.channels[1], b.channels[1]) &&
+           configEquals(a.channels[2], b.channels[2]);
+}
+
+uint64_t configHash(const glic::CodecConfig& config) {
+    Hasher h;
+#define OFXGLIC_HASH(field) h.addField(config.field);
+    OFXGLIC_CODEC_CONFIG_FIELDS(OFXGLIC_HASH)
+#undef OFXGLIC_HASH
+    for (const auto& c : config.channels) {
+#define OFXGLIC_HASH(field) h.addField(c.field);
+        OFXGLIC_CHANNEL_CONFIG_FIELDS(OFXGLIC_HASH)
+#undef OFXGLIC_HASH
+    }
+    return h.value;
+}
+
+}
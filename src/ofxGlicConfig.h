@@ -4,3 +4,33 @@
 // This file simply includes the internal glic configuration
 
 #include "glic/config.hpp"
+#include <cstddef>
+#include <memory>
+
+// Immutable, shareable codec config
+// Any number of threads can hold and read the same snapshot without locking;
+// to change settings, make a new snapshot.
+using ofxGlicConfigSnapshot = std::shared_ptr<const glic::CodecConfig>;
+
+namespace ofxGlic {
+    inline ofxGlicConfigSnapshot makeConfigSnapshot(const glic::CodecConfig& config = glic::CodecConfig()) {
+        return std::make_shared<const glic::CodecConfig>(config);
+    }
+}
+
+namespace ofxGlic {
+    // Field-by-field equality and hash of a codec config
+    // The hash only depends on the settings, so it is the same across runs and platforms.
+    bool configEquals(const glic::CodecConfig& a, const glic::CodecConfig& b);
+    bool configEquals(const glic::ChannelConfig& a, const glic::ChannelConfig& b);
+    uint64_t configHash(const glic::CodecConfig& config);
+}
+
+// Functors for unordered containers keyed by glic::CodecConfig
+struct ofxGlicConfigHash {
+    size_t operator()(const glic::CodecConfig& config) const { return size_t(ofxGlic::configHash(config)); }
+};
+
+struct ofxGlicConfigEqual {
+    bool operator()(const glic::CodecConfig& a, const glic::CodecConfig& b) const { return ofxGlic::configEquals(a, b); }
+};
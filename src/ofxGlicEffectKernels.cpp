@@ -0,0 +1,946 @@
+#include "ofxGlicEffectKernels.h"
+#include "ofxGlicSimd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(OFXGLIC_SIMD_X86)
+    #include <immintrin.h>
+#endif
+#if defined(OFXGLIC_SIMD_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace {
+    using Form = ofxGlicEffectTable::Form;
+
+    // 16-bit factor with clamp(((v * scale) >> 16) + offset) == t[v]
+    bool findScale(const uint8_t* t, int offset, uint16_t& scale) {
+        int64_t lo = 0, hi = 65535;
+        for (int v = 1; v < 256 && lo <= hi; v++) {
+            // Range of (v * scale) >> 16 that clamps to the entry
+            int64_t minValue = t[v] == 0 ? 0 : t[v] == 255 ? 255 - offset : t[v] - offset;
+            int64_t maxValue = t[v] == 0 ? -offset : t[v] == 255 ? 255 : t[v] - offset;
+            if (minValue > maxValue || maxValue < 0) return false;
+            minValue = std::max<int64_t>(0, minValue);
+            lo = std::max<int64_t>(lo, (minValue * 65536 + v - 1) / v);
+            hi = std::min<int64_t>(hi, ((maxValue + 1) * 65536 + v - 1) / v - 1);
+        }
+        if (lo > hi) return false;
+        for (int v = 0; v < 256; v++) {
+            if (t[v] != std::min<int64_t>(255, std::max<int64_t>(0, ((v * lo) >> 16) + offset))) return false;
+        }
+        scale = uint16_t(lo);
+        return true;
+    }
+
+    // Every candidate is checked against all 256 entries, so a form is exact
+    bool findForm(const uint8_t* t, Form& form) {
+        form = Form();
+
+        // Dither: the offset comes from any entry that is not clamped
+        for (int v = 0; v < 256; v++) {
+            if (t[v] == 0 || t[v] == 255) continue;
+            int offset = t[v] - v;
+            bool matches = true;
+            for (int u = 0; u < 256 && matches; u++) {
+                matches = t[u] == std::min(255, std::max(0, u + offset));
+            }
+            if (matches) {
+                form.kind = Form::ADD;
+                form.offset = offset;
+                return true;
+            }
+            break;
+        }
+
+        // Scanline, alone or before dither: clamped offset at v = 0 decides
+        // which offsets can work
+        if (t[0] < 255) {
+            int first = t[0] > 0 ? t[0] : 0;
+            int last = t[0] > 0 ? t[0] : -255;
+            for (int offset = first; offset >= last; offset--) {
+                if (findScale(t, offset, form.scale)) {
+                    form.kind = Form::SCALE;
+                    form.offset = offset;
+                    return true;
+                }
+            }
+        }
+
+        // Posterize, alone or fused with the others: few distinct runs
+        for (int v = 1; v < 256; v++) {
+            if (t[v] == t[v - 1]) continue;
+            if (form.numSteps == Form::maxSteps) return false;
+            form.thresholds[form.numSteps] = uint8_t(v);
+            form.deltas[form.numSteps] = uint8_t(t[v] - t[v - 1]);
+            form.numSteps++;
+        }
+        form.kind = Form::STEPS;
+        form.base = t[0];
+        return true;
+    }
+}
+
+void ofxGlicEffectTable::analyze() {
+    identityRows.assign(periodY, true);
+    vectorRows.assign(periodY, true);
+    forms.resize(size_t(periodX) * periodY * 4);
+    preservesGray = true;
+    for (int y = 0; y < periodY; y++) {
+        for (int x = 0; x < periodX; x++) {
+            const uint8_t* t = at(x, y);
+            for (int i = 0; i < 1024 && identityRows[y]; i++) {
+                if (t[i] != (i & 255)) identityRows[y] = false;
+            }
+            for (int i = 0; i < 256 && preservesGray; i++) {
+                if (t[i] != t[256 + i] || t[i] != t[512 + i]) preservesGray = false;
+            }
+            for (int c = 0; c < 4; c++) {
+                if (!findForm(t + c * 256, forms[size_t(y * periodX + x) * 4 + c])) vectorRows[y] = false;
+            }
+        }
+    }
+}
+
+namespace {
+    using ofxGlic::kernels::EffectLayout;
+
+    template<bool Gray, bool Alpha>
+    void applyTableRows(const ofxGlicEffectTable& table, uint8_t* data, int width, int y0, int y1,
+                        const EffectLayout& layout) {
+        const int r = layout.r, g = layout.g, b = layout.b, a = layout.a, stride = layout.stride;
+        const int mask = table.periodX - 1;
+
+        for (int y = y0; y < y1; y++) {
+            int phaseY = y % table.periodY;
+            if (table.identityRows[phaseY]) continue;
+
+            const uint8_t* row = table.at(0, phaseY);
+            uint8_t* p = data + size_t(y) * width * stride;
+            for (int x = 0; x < width; x++, p += stride) {
+                const uint8_t* t = mask == 0 ? row : row + size_t(x & mask) * 1024;
+                if (Gray) {
+                    uint8_t v = p[r];
+                    p[r] = std::max(t[v], std::max(t[256 + v], t[512 + v]));
+                } else {
+                    p[r] = t[p[r]];
+                    p[g] = t[256 + p[g]];
+                    p[b] = t[512 + p[b]];
+                }
+                if (Alpha) p[a] = t[768 + p[a]];
+            }
+        }
+    }
+
+    void applyTableScalar(const ofxGlicEffectTable& table, uint8_t* data, int width, const EffectLayout& layout,
+                          int y0, int y1) {
+        bool gray = layout.isGray();
+        bool alpha = layout.a >= 0;
+        if (gray && alpha)       applyTableRows<true, true>(table, data, width, y0, y1, layout);
+        else if (gray)           applyTableRows<true, false>(table, data, width, y0, y1, layout);
+        else if (alpha)          applyTableRows<false, true>(table, data, width, y0, y1, layout);
+        else                     applyTableRows<false, false>(table, data, width, y0, y1, layout);
+    }
+
+    // The forms of one table row, spread over the bytes of a pixel row
+    // Byte i of the row uses lane i % length, where length is a multiple of
+    // both the 32-byte vector and the pixel pattern (periodX * stride).
+    // Each lane goes through scale, then add, and STEPS lanes take the steps
+    // of the input instead; unused parts leave a lane unchanged.
+    struct RowProgram {
+        static const int maxLength = 96;  // 3-byte pixels with period 8
+
+        int length = 0;
+        bool scale = false;
+        bool add = false;
+        int numSteps = 0;
+        alignas(32) uint16_t scaleFactors[maxLength];
+        alignas(32) uint8_t scaleMask[maxLength];
+        alignas(32) uint8_t addPositive[maxLength];
+        alignas(32) uint8_t addNegative[maxLength];
+        alignas(32) uint8_t stepMask[maxLength];
+        alignas(32) uint8_t stepBase[maxLength];
+        // Threshold - 1 with the sign bit flipped, for signed compares
+        alignas(32) uint8_t stepBelow[Form::maxSteps][maxLength];
+        alignas(32) uint8_t stepDeltas[Form::maxSteps][maxLength];
+
+        // When all STEPS lanes share one form with at most one step inside
+        // each run of 16 values (posterize up to 16 levels), a byte shuffle
+        // indexed by the high nibble replaces the compares: the output at the
+        // start of the run, the low nibble it changes after, and by how much
+        bool nibbles = false;
+        alignas(16) uint8_t nibbleBase[16];
+        alignas(16) uint8_t nibbleBelow[16];
+        alignas(16) uint8_t nibbleDeltas[16];
+    };
+
+    bool sameSteps(const Form& a, const Form& b) {
+        return a.base == b.base && a.numSteps == b.numSteps &&
+               std::equal(a.thresholds, a.thresholds + a.numSteps, b.thresholds) &&
+               std::equal(a.deltas, a.deltas + a.numSteps, b.deltas);
+    }
+
+    bool makeNibbleSteps(const Form& form, RowProgram& program) {
+        uint8_t values[256];
+        for (int v = 0, k = 0, value = form.base; v < 256; v++) {
+            for (; k < form.numSteps && form.thresholds[k] == v; k++) value += form.deltas[k];
+            values[v] = uint8_t(value);
+        }
+        for (int h = 0; h < 16; h++) {
+            const uint8_t* run = values + h * 16;
+            program.nibbleBase[h] = run[0];
+            program.nibbleBelow[h] = 15;
+            program.nibbleDeltas[h] = 0;
+            for (int lo = 1; lo < 16; lo++) {
+                if (run[lo] == run[lo - 1]) continue;
+                if (program.nibbleBelow[h] != 15) return false;
+                program.nibbleBelow[h] = uint8_t(lo - 1);
+                program.nibbleDeltas[h] = uint8_t(run[lo] - run[0]);
+            }
+        }
+        return true;
+    }
+
+    // Table channel of each byte of a pixel; gray needs table.preservesGray
+    void getByteChannels(const EffectLayout& layout, int channels[4]) {
+        for (int o = 0; o < layout.stride; o++) {
+            channels[o] = o == layout.a ? 3 : o == layout.r ? 0 : o == layout.g ? 1 : 2;
+        }
+    }
+
+    void makeRowProgram(const ofxGlicEffectTable& table, int phaseY, const EffectLayout& layout,
+                        RowProgram& program) {
+        int channels[4];
+        getByteChannels(layout, channels);
+        const int stride = layout.stride;
+        const int mask = table.periodX - 1;
+        const int pattern = table.periodX * stride;
+        int length = pattern;
+        while (length % 32 != 0) length += pattern;
+
+        program = RowProgram();
+        std::fill_n(&program.stepBelow[0][0], Form::maxSteps * RowProgram::maxLength, uint8_t(0x7F));
+        std::fill_n(&program.stepDeltas[0][0], Form::maxSteps * RowProgram::maxLength, uint8_t(0));
+        program.length = length;
+        const Form* steps = nullptr;
+        bool shared = true;
+        for (int i = 0; i < length; i++) {
+            const Form& form = table.forms[size_t(phaseY * table.periodX + ((i / stride) & mask)) * 4 +
+                                           channels[i % stride]];
+            bool isScale = form.kind == Form::SCALE;
+            bool isSteps = form.kind == Form::STEPS;
+            int offset = form.offset;
+            program.scaleFactors[i] = isScale ? form.scale : 0;
+            program.scaleMask[i] = isScale ? 0xFF : 0;
+            program.addPositive[i] = uint8_t(std::max(0, offset));
+            program.addNegative[i] = uint8_t(std::max(0, -offset));
+            program.stepMask[i] = isSteps ? 0xFF : 0;
+            program.stepBase[i] = isSteps ? form.base : 0;
+            program.scale = program.scale || isScale;
+            program.add = program.add || offset != 0;
+            if (!isSteps) continue;
+
+            for (int k = 0; k < form.numSteps; k++) {
+                program.stepBelow[k][i] = uint8_t((form.thresholds[k] - 1) ^ 0x80);
+                program.stepDeltas[k][i] = form.deltas[k];
+            }
+            // A constant table still needs the pass that writes its base
+            program.numSteps = std::max(program.numSteps, std::max(1, form.numSteps));
+            shared = shared && (!steps || sameSteps(*steps, form));
+            steps = &form;
+        }
+        program.nibbles = steps && shared && makeNibbleSteps(*steps, program);
+    }
+
+    // Bytes [begin, end) of a row through the lookup table
+    void applyTableBytes(const ofxGlicEffectTable& table, int phaseY, const EffectLayout& layout, uint8_t* row,
+                         size_t begin, size_t end) {
+        int channels[4];
+        getByteChannels(layout, channels);
+        const int mask = table.periodX - 1;
+        for (size_t i = begin; i < end; i++) {
+            const uint8_t* t = table.at(int(i / layout.stride) & mask, phaseY) + channels[i % layout.stride] * 256;
+            row[i] = t[row[i]];
+        }
+    }
+
+    // Map the leading whole vectors of a row; returns the bytes done
+    using RowKernel = size_t (*)(const RowProgram& program, uint8_t* row, size_t numBytes);
+
+#if defined(OFXGLIC_SIMD_X86)
+    // Program lanes are aligned to the vector size
+    OFXGLIC_TARGET("sse2")
+    inline __m128i load128(const void* lane) {
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(lane));
+    }
+
+    OFXGLIC_TARGET("avx2")
+    inline __m256i load256(const void* lane) {
+        return _mm256_load_si256(reinterpret_cast<const __m256i*>(lane));
+    }
+
+    // Scale and add parts of 16 lanes
+    OFXGLIC_TARGET("sse2")
+    inline __m128i scaleAddSse2(const RowProgram& p, int lane, __m128i v, bool scale, bool add) {
+        __m128i x = v;
+        if (scale) {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(v, zero), load128(p.scaleFactors + lane));
+            __m128i hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(v, zero), load128(p.scaleFactors + lane + 8));
+            __m128i m = load128(p.scaleMask + lane);
+            x = _mm_or_si128(_mm_and_si128(m, _mm_packus_epi16(lo, hi)), _mm_andnot_si128(m, x));
+        }
+        if (add) {
+            x = _mm_subs_epu8(_mm_adds_epu8(x, load128(p.addPositive + lane)), load128(p.addNegative + lane));
+        }
+        return x;
+    }
+
+    OFXGLIC_TARGET("sse2")
+    size_t applyRowSse2(const RowProgram& p, uint8_t* row, size_t numBytes) {
+        const bool scale = p.scale, add = p.add;
+        const int numSteps = p.numSteps, length = p.length;
+        const __m128i sign = _mm_set1_epi8(char(0x80));
+
+        size_t i = 0;
+        for (int lane = 0; i + 16 <= numBytes; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i x = scaleAddSse2(p, lane, v, scale, add);
+            if (numSteps > 0) {
+                __m128i signedV = _mm_xor_si128(v, sign);
+                __m128i steps = load128(p.stepBase + lane);
+                for (int k = 0; k < numSteps; k++) {
+                    __m128i reached = _mm_cmpgt_epi8(signedV, load128(p.stepBelow[k] + lane));
+                    steps = _mm_add_epi8(steps, _mm_and_si128(reached, load128(p.stepDeltas[k] + lane)));
+                }
+                x = _mm_or_si128(_mm_andnot_si128(load128(p.stepMask + lane), x), steps);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), x);
+            lane += 16;
+            if (lane == length) lane = 0;
+        }
+        return i;
+    }
+
+    OFXGLIC_TARGET("ssse3")
+    size_t applyRowSsse3(const RowProgram& p, uint8_t* row, size_t numBytes) {
+        if (!p.nibbles) return applyRowSse2(p, row, numBytes);
+
+        const bool scale = p.scale, add = p.add;
+        const int length = p.length;
+        const __m128i low = _mm_set1_epi8(0x0F);
+        const __m128i base = load128(p.nibbleBase);
+        const __m128i below = load128(p.nibbleBelow);
+        const __m128i deltas = load128(p.nibbleDeltas);
+
+        size_t i = 0;
+        for (int lane = 0; i + 16 <= numBytes; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i x = scaleAddSse2(p, lane, v, scale, add);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low);
+            __m128i reached = _mm_cmpgt_epi8(_mm_and_si128(v, low), _mm_shuffle_epi8(below, hi));
+            __m128i steps = _mm_add_epi8(_mm_shuffle_epi8(base, hi),
+                                         _mm_and_si128(reached, _mm_shuffle_epi8(deltas, hi)));
+            __m128i m = load128(p.stepMask + lane);
+            x = _mm_or_si128(_mm_andnot_si128(m, x), _mm_and_si128(m, steps));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), x);
+            lane += 16;
+            if (lane == length) lane = 0;
+        }
+        return i;
+    }
+
+    OFXGLIC_TARGET("avx2")
+    size_t applyRowAvx2(const RowProgram& p, uint8_t* row, size_t numBytes) {
+        const bool scale = p.scale, add = p.add, nibbles = p.nibbles;
+        const int numSteps = p.numSteps, length = p.length;
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i sign = _mm256_set1_epi8(char(0x80));
+        const __m256i low = _mm256_set1_epi8(0x0F);
+        const __m256i base = _mm256_broadcastsi128_si256(load128(p.nibbleBase));
+        const __m256i below = _mm256_broadcastsi128_si256(load128(p.nibbleBelow));
+        const __m256i deltas = _mm256_broadcastsi128_si256(load128(p.nibbleDeltas));
+
+        size_t i = 0;
+        for (int lane = 0; i + 32 <= numBytes; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+            __m256i x = v;
+            if (scale) {
+                // Unpacking works within 128-bit halves, so the factors are regrouped to match
+                __m256i f0 = load256(p.scaleFactors + lane);
+                __m256i f1 = load256(p.scaleFactors + lane + 16);
+                __m256i lo = _mm256_mulhi_epu16(_mm256_unpacklo_epi8(v, zero), _mm256_permute2x128_si256(f0, f1, 0x20));
+                __m256i hi = _mm256_mulhi_epu16(_mm256_unpackhi_epi8(v, zero), _mm256_permute2x128_si256(f0, f1, 0x31));
+                x = _mm256_blendv_epi8(x, _mm256_packus_epi16(lo, hi), load256(p.scaleMask + lane));
+            }
+            if (add) {
+                x = _mm256_subs_epu8(_mm256_adds_epu8(x, load256(p.addPositive + lane)), load256(p.addNegative + lane));
+            }
+            if (nibbles) {
+                __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+                __m256i reached = _mm256_cmpgt_epi8(_mm256_and_si256(v, low), _mm256_shuffle_epi8(below, hi));
+                __m256i steps = _mm256_add_epi8(_mm256_shuffle_epi8(base, hi),
+                                                _mm256_and_si256(reached, _mm256_shuffle_epi8(deltas, hi)));
+                x = _mm256_blendv_epi8(x, steps, load256(p.stepMask + lane));
+            } else if (numSteps > 0) {
+                __m256i signedV = _mm256_xor_si256(v, sign);
+                __m256i steps = load256(p.stepBase + lane);
+                for (int k = 0; k < numSteps; k++) {
+                    __m256i reached = _mm256_cmpgt_epi8(signedV, load256(p.stepBelow[k] + lane));
+                    steps = _mm256_add_epi8(steps, _mm256_and_si256(reached, load256(p.stepDeltas[k] + lane)));
+                }
+                x = _mm256_blendv_epi8(x, steps, load256(p.stepMask + lane));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), x);
+            lane += 32;
+            if (lane == length) lane = 0;
+        }
+        return i;
+    }
+#endif
+
+#if defined(OFXGLIC_SIMD_NEON)
+    uint16x8_t mulhiNeon(uint16x8_t a, uint16x8_t b) {
+        uint32x4_t lo = vmull_u16(vget_low_u16(a), vget_low_u16(b));
+        uint32x4_t hi = vmull_u16(vget_high_u16(a), vget_high_u16(b));
+        return vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16));
+    }
+
+    size_t applyRowNeon(const RowProgram& p, uint8_t* row, size_t numBytes) {
+        const bool scale = p.scale, add = p.add;
+        const int numSteps = p.numSteps, length = p.length;
+        const uint8x16_t sign = vdupq_n_u8(0x80);
+#if defined(__aarch64__)
+        const bool nibbles = p.nibbles;
+        const uint8x16_t low = vdupq_n_u8(0x0F);
+        const uint8x16_t base = vld1q_u8(p.nibbleBase);
+        const uint8x16_t below = vld1q_u8(p.nibbleBelow);
+        const uint8x16_t deltas = vld1q_u8(p.nibbleDeltas);
+#else
+        const bool nibbles = false;
+#endif
+
+        size_t i = 0;
+        for (int lane = 0; i + 16 <= numBytes; i += 16) {
+            uint8x16_t v = vld1q_u8(row + i);
+            uint8x16_t x = v;
+            if (scale) {
+                uint16x8_t lo = mulhiNeon(vmovl_u8(vget_low_u8(v)), vld1q_u16(p.scaleFactors + lane));
+                uint16x8_t hi = mulhiNeon(vmovl_u8(vget_high_u8(v)), vld1q_u16(p.scaleFactors + lane + 8));
+                x = vbslq_u8(vld1q_u8(p.scaleMask + lane), vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)), x);
+            }
+            if (add) {
+                x = vqsubq_u8(vqaddq_u8(x, vld1q_u8(p.addPositive + lane)), vld1q_u8(p.addNegative + lane));
+            }
+            if (nibbles) {
+#if defined(__aarch64__)
+                uint8x16_t hi = vshrq_n_u8(v, 4);
+                uint8x16_t reached = vcgtq_u8(vandq_u8(v, low), vqtbl1q_u8(below, hi));
+                uint8x16_t steps = vaddq_u8(vqtbl1q_u8(base, hi), vandq_u8(reached, vqtbl1q_u8(deltas, hi)));
+                x = vbslq_u8(vld1q_u8(p.stepMask + lane), steps, x);
+#endif
+            } else if (numSteps > 0) {
+                int8x16_t signedV = vreinterpretq_s8_u8(veorq_u8(v, sign));
+                uint8x16_t steps = vld1q_u8(p.stepBase + lane);
+                for (int k = 0; k < numSteps; k++) {
+                    uint8x16_t reached = vcgtq_s8(signedV, vreinterpretq_s8_u8(vld1q_u8(p.stepBelow[k] + lane)));
+                    steps = vaddq_u8(steps, vandq_u8(reached, vld1q_u8(p.stepDeltas[k] + lane)));
+                }
+                x = vbslq_u8(vld1q_u8(p.stepMask + lane), steps, x);
+            }
+            vst1q_u8(row + i, x);
+            lane += 16;
+            if (lane == length) lane = 0;
+        }
+        return i;
+    }
+#endif
+
+    // nullptr when dispatch is SCALAR
+    RowKernel getRowKernel() {
+        switch (ofxGlic::getSimdLevel()) {
+#if defined(OFXGLIC_SIMD_X86)
+            case ofxGlic::SimdLevel::AVX2: return applyRowAvx2;
+            case ofxGlic::SimdLevel::SSSE3: return applyRowSsse3;
+            case ofxGlic::SimdLevel::SSE2: return applyRowSse2;
+#endif
+#if defined(OFXGLIC_SIMD_NEON)
+            case ofxGlic::SimdLevel::NEON: return applyRowNeon;
+#endif
+            default: return nullptr;
+        }
+    }
+
+    // Pixels with alpha in their last channel: the other channels of count
+    // pixels from src, keeping dst's alpha
+    void copyColorRowScalar(const uint8_t* src, uint8_t* dst, size_t count, int stride) {
+        for (size_t i = 0; i < count; i++, src += stride, dst += stride) {
+            for (int c = 0; c < stride - 1; c++) dst[c] = src[c];
+        }
+    }
+
+    // Byte i is a color byte unless i % stride is the last channel
+    void getColorByteMask(int stride, uint8_t* mask, int size) {
+        for (int i = 0; i < size; i++) mask[i] = i % stride == stride - 1 ? 0 : 0xFF;
+    }
+
+#if defined(OFXGLIC_SIMD_X86)
+    OFXGLIC_TARGET("sse2")
+    void copyColorRowSse2(const uint8_t* src, uint8_t* dst, size_t count, int stride) {
+        alignas(16) uint8_t maskBytes[16];
+        getColorByteMask(stride, maskBytes, 16);
+        const __m128i mask = load128(maskBytes);
+        const size_t numBytes = count * stride;
+        size_t i = 0;
+        for (; i + 16 <= numBytes; i += 16) {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            d = _mm_or_si128(_mm_and_si128(mask, s), _mm_andnot_si128(mask, d));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), d);
+        }
+        copyColorRowScalar(src + i, dst + i, count - i / stride, stride);
+    }
+
+    OFXGLIC_TARGET("avx2")
+    void copyColorRowAvx2(const uint8_t* src, uint8_t* dst, size_t count, int stride) {
+        alignas(32) uint8_t maskBytes[32];
+        getColorByteMask(stride, maskBytes, 32);
+        const __m256i mask = load256(maskBytes);
+        const size_t numBytes = count * stride;
+        size_t i = 0;
+        for (; i + 32 <= numBytes; i += 32) {
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(d, s, mask));
+        }
+        copyColorRowScalar(src + i, dst + i, count - i / stride, stride);
+    }
+#endif
+
+#if defined(OFXGLIC_SIMD_NEON)
+    void copyColorRowNeon(const uint8_t* src, uint8_t* dst, size_t count, int stride) {
+        uint8_t maskBytes[16];
+        getColorByteMask(stride, maskBytes, 16);
+        const uint8x16_t mask = vld1q_u8(maskBytes);
+        const size_t numBytes = count * stride;
+        size_t i = 0;
+        for (; i + 16 <= numBytes; i += 16) {
+            vst1q_u8(dst + i, vbslq_u8(mask, vld1q_u8(src + i), vld1q_u8(dst + i)));
+        }
+        copyColorRowScalar(src + i, dst + i, count - i / stride, stride);
+    }
+#endif
+
+    // stride is 2 or 4, which divides the vector size
+    void copyColorRow(const uint8_t* src, uint8_t* dst, size_t count, int stride) {
+        switch (ofxGlic::getSimdLevel()) {
+#if defined(OFXGLIC_SIMD_X86)
+            case ofxGlic::SimdLevel::AVX2: copyColorRowAvx2(src, dst, count, stride); return;
+            case ofxGlic::SimdLevel::SSSE3:
+            case ofxGlic::SimdLevel::SSE2: copyColorRowSse2(src, dst, count, stride); return;
+#endif
+#if defined(OFXGLIC_SIMD_NEON)
+            case ofxGlic::SimdLevel::NEON: copyColorRowNeon(src, dst, count, stride); return;
+#endif
+            default: copyColorRowScalar(src, dst, count, stride); return;
+        }
+    }
+
+    void copyColorRow(const float* src, float* dst, size_t count, int stride) {
+        for (size_t i = 0; i < count; i++, src += stride, dst += stride) {
+            std::copy(src, src + stride - 1, dst);
+        }
+    }
+
+    // columns[i] += row[i] for count bytes; the widening from 8 to 32 bits
+    // keeps the compiler from vectorizing the plain loop at -O2
+    void addRowScalar(const uint8_t* row, uint32_t* columns, size_t count) {
+        for (size_t i = 0; i < count; i++) columns[i] += row[i];
+    }
+
+#if defined(OFXGLIC_SIMD_X86)
+    OFXGLIC_TARGET("sse2")
+    void addRowSse2(const uint8_t* row, uint32_t* columns, size_t count) {
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+            __m128i low = _mm_unpacklo_epi8(bytes, zero);
+            __m128i high = _mm_unpackhi_epi8(bytes, zero);
+            __m128i words[4] = {_mm_unpacklo_epi16(low, zero), _mm_unpackhi_epi16(low, zero),
+                                _mm_unpacklo_epi16(high, zero), _mm_unpackhi_epi16(high, zero)};
+            for (int k = 0; k < 4; k++) {
+                __m128i* column = reinterpret_cast<__m128i*>(columns + i + k * 4);
+                _mm_storeu_si128(column, _mm_add_epi32(_mm_loadu_si128(column), words[k]));
+            }
+        }
+        addRowScalar(row + i, columns + i, count - i);
+    }
+
+    OFXGLIC_TARGET("avx2")
+    void addRowAvx2(const uint8_t* row, uint32_t* columns, size_t count) {
+        size_t i = 0;
+        for (; i + 32 <= count; i += 32) {
+            for (int k = 0; k < 4; k++) {
+                __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i + k * 8));
+                __m256i* column = reinterpret_cast<__m256i*>(columns + i + k * 8);
+                _mm256_storeu_si256(column, _mm256_add_epi32(_mm256_loadu_si256(column),
+                                                             _mm256_cvtepu8_epi32(bytes)));
+            }
+        }
+        addRowScalar(row + i, columns + i, count - i);
+    }
+#endif
+
+#if defined(OFXGLIC_SIMD_NEON)
+    void addRowNeon(const uint8_t* row, uint32_t* columns, size_t count) {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            uint8x16_t bytes = vld1q_u8(row + i);
+            uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+            uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+            uint32_t* column = columns + i;
+            vst1q_u32(column, vaddw_u16(vld1q_u32(column), vget_low_u16(low)));
+            vst1q_u32(column + 4, vaddw_u16(vld1q_u32(column + 4), vget_high_u16(low)));
+            vst1q_u32(column + 8, vaddw_u16(vld1q_u32(column + 8), vget_low_u16(high)));
+            vst1q_u32(column + 12, vaddw_u16(vld1q_u32(column + 12), vget_high_u16(high)));
+        }
+        addRowScalar(row + i, columns + i, count - i);
+    }
+#endif
+
+    void addRow(const uint8_t* row, uint32_t* columns, size_t count) {
+        switch (ofxGlic::getSimdLevel()) {
+#if defined(OFXGLIC_SIMD_X86)
+            case ofxGlic::SimdLevel::AVX2: addRowAvx2(row, columns, count); return;
+            case ofxGlic::SimdLevel::SSSE3:
+            case ofxGlic::SimdLevel::SSE2: addRowSse2(row, columns, count); return;
+#endif
+#if defined(OFXGLIC_SIMD_NEON)
+            case ofxGlic::SimdLevel::NEON: addRowNeon(row, columns, count); return;
+#endif
+            default: addRowScalar(row, columns, count); return;
+        }
+    }
+
+    void addRow(const float* row, double* columns, size_t count) {
+        for (size_t i = 0; i < count; i++) columns[i] += row[i];
+    }
+
+    // Truncated total / count for 8-bit channels without an integer division
+    // per block: the quotient is at most 255, so double's error stays far
+    // below the 0.5 / count margin and the result is exact.
+    template<typename T>
+    T divideSum(uint32_t total, uint64_t, double reciprocal) {
+        return T((double(total) + 0.5) * reciprocal);
+    }
+
+    template<typename T>
+    T divideSum(double total, uint64_t count, double) {
+        return T(total / double(count));
+    }
+
+    // Color channels are the first NumChannels of each pixel in every layout,
+    // and averaging treats them alike, so their order does not matter.
+    // 8-bit averages truncate, as glic's integer arithmetic does; float
+    // averages are exact.
+    // Blocks start at (x0, y0) and are cut at x1 and y1; rows are width
+    // pixels apart. sums[x * Stride + c] becomes channel c summed over the
+    // block row and columns [x0, x0 + x). Unsigned sums wrap, which leaves
+    // the difference of two of them exact as long as a block's true sum
+    // fits; Prefix is false for blocks too large for that, which then add up
+    // their column sums.
+    template<typename T, typename Sum, int NumChannels, int Stride, bool Prefix>
+    void pixelateBlockRows(T* data, int width, int x0, int y0, int x1, int y1, int blockWidth, int blockHeight,
+                           Sum* sums) {
+        const size_t rowSize = size_t(width) * Stride;
+        const int spanWidth = x1 - x0;
+        const size_t spanSize = size_t(spanWidth) * Stride;
+        data += size_t(x0) * Stride;
+        Sum* columns = sums + Stride;
+        for (int by = y0; by < y1; by += blockHeight) {
+            int ey = std::min(y1, by + blockHeight);
+
+            // Whole rows at a time, so the additions vectorize
+            T* top = data + size_t(by) * rowSize;
+            std::fill(sums, columns + spanSize, Sum(0));
+            for (int y = by; y < ey; y++) {
+                addRow(data + size_t(y) * rowSize, columns, spanSize);
+            }
+            if (Prefix) {
+                for (size_t i = Stride; i < spanSize + Stride; i++) sums[i] += sums[i - Stride];
+            }
+
+            for (int bx = 0; bx < spanWidth; bx += blockWidth) {
+                int ex = std::min(spanWidth, bx + blockWidth);
+                uint64_t count = uint64_t(ey - by) * uint64_t(ex - bx);
+                double reciprocal = 1.0 / double(count);
+                T average[NumChannels];
+                for (int c = 0; c < NumChannels; c++) {
+                    if (Prefix) {
+                        Sum total = sums[size_t(ex) * Stride + c] - sums[size_t(bx) * Stride + c];
+                        average[c] = divideSum<T>(total, count, reciprocal);
+                    } else {
+                        uint64_t total = 0;
+                        for (int x = bx; x < ex; x++) total += columns[size_t(x) * Stride + c];
+                        average[c] = T(total / count);
+                    }
+                }
+                T* p = top + size_t(bx) * Stride;
+                for (int x = bx; x < ex; x++, p += Stride) {
+                    for (int c = 0; c < NumChannels; c++) p[c] = average[c];
+                }
+            }
+
+            for (int y = by + 1; y < ey; y++) {
+                T* row = data + size_t(y) * rowSize;
+                if (NumChannels == Stride) {
+                    std::copy(top, top + spanSize, row);
+                } else {
+                    copyColorRow(top, row, size_t(spanWidth), Stride);
+                }
+            }
+        }
+    }
+
+    template<typename T, typename Sum, bool Prefix>
+    void pixelateLayout(T* data, int width, const EffectLayout& layout, int x0, int y0, int x1, int y1,
+                        int blockWidth, int blockHeight, Sum* sums) {
+        using BlockRows = void (*)(T*, int, int, int, int, int, int, int, Sum*);
+        BlockRows blockRows;
+        switch (layout.stride) {
+            case 1: blockRows = pixelateBlockRows<T, Sum, 1, 1, Prefix>; break;
+            case 2: blockRows = pixelateBlockRows<T, Sum, 1, 2, Prefix>; break;
+            case 3: blockRows = pixelateBlockRows<T, Sum, 3, 3, Prefix>; break;
+            case 4: blockRows = pixelateBlockRows<T, Sum, 3, 4, Prefix>; break;
+            default: return;
+        }
+        blockRows(data, width, x0, y0, x1, y1, blockWidth, blockHeight, sums);
+    }
+
+    // out(x, y) = in(x - dx, y - dy) for one channel and rows [y0, y1), clamped
+    // to the image. Rows and columns are visited so that every source is read
+    // before it is overwritten, which makes the shift work in place. Rows
+    // outside the band are read from halo (see getChromaticHalo).
+    template<typename T>
+    void shiftChannel(T* data, int width, int height, int stride, int channel, int dx, int dy,
+                      int y0, int y1, const T* halo, int haloAbove) {
+        if (dx == 0 && dy == 0) return;
+        const size_t rowSize = size_t(width) * stride;
+        for (int i = y0; i < y1; i++) {
+            int y = dy >= 0 ? y1 - 1 - (i - y0) : i;
+            int sy = std::min(height - 1, std::max(0, y - dy));
+            const T* src;
+            if (sy < y0) {
+                src = halo + size_t(sy - (y0 - haloAbove)) * rowSize;
+            } else if (sy >= y1) {
+                src = halo + size_t(haloAbove + sy - y1) * rowSize;
+            } else {
+                src = data + size_t(sy) * rowSize;
+            }
+            src += channel;
+            T* dst = data + size_t(y) * rowSize + channel;
+            for (int j = 0; j < width; j++) {
+                int x = dx >= 0 ? width - 1 - j : j;
+                int sx = std::min(width - 1, std::max(0, x - dx));
+                dst[size_t(x) * stride] = src[size_t(sx) * stride];
+            }
+        }
+    }
+
+    template<typename T>
+    void chromaticImpl(T* data, int width, int height, const EffectLayout& layout, int offsetX, int offsetY,
+                       int y0, int y1, const T* halo) {
+        if (layout.isGray() || width <= 0 || y0 >= y1) return;
+        int above, below;
+        ofxGlic::kernels::getChromaticHalo(height, offsetY, y0, y1, above, below);
+        shiftChannel(data, width, height, layout.stride, layout.r, offsetX, offsetY, y0, y1, halo, above);
+        shiftChannel(data, width, height, layout.stride, layout.b, -offsetX, -offsetY, y0, y1, halo, above);
+    }
+
+    // Bands start at a multiple of blockSize; the random state is advanced
+    // past the block rows above, so every band sees the same sequence
+    template<typename T>
+    void glitchShiftImpl(T* data, int width, int height, const EffectLayout& layout, int blockSize, uint32_t seed,
+                         int y0, int y1) {
+        const int stride = layout.stride;
+        blockSize = std::max(1, blockSize);
+        uint32_t state = seed;
+        for (int by = 0; by < y0; by += blockSize) {
+            state = state * 1664525u + 1013904223u;
+        }
+        for (int by = y0; by < y1; by += blockSize) {
+            state = state * 1664525u + 1013904223u;
+            int shift = int(state >> 24) % std::max(1, width / 8);
+            if ((state >> 8) % 3 != 0 || shift == 0) continue;
+            for (int y = by; y < std::min(height, by + blockSize); y++) {
+                T* row = data + size_t(y) * width * stride;
+                std::rotate(row, row + size_t(shift) * stride, row + size_t(width) * stride);
+            }
+        }
+    }
+
+    const int bayer4[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+    // One effect on the color channels of row y
+    template<int NumChannels>
+    void applyFloatEffect(const ofxGlic::kernels::FloatEffect& effect, float* row, int width, int stride, int y) {
+        using FloatEffect = ofxGlic::kernels::FloatEffect;
+        switch (effect.kind) {
+            case FloatEffect::SCANLINE:
+                if (y % 2 == 0) return;
+                for (int x = 0; x < width; x++, row += stride) {
+                    for (int c = 0; c < NumChannels; c++) row[c] *= effect.amount;
+                }
+                return;
+            case FloatEffect::DITHER: {
+                float offsets[4];
+                for (int i = 0; i < 4; i++) offsets[i] = float(bayer4[y & 3][i] - 8) * effect.amount;
+                for (int x = 0; x < width; x++, row += stride) {
+                    for (int c = 0; c < NumChannels; c++) row[c] += offsets[x & 3];
+                }
+                return;
+            }
+            case FloatEffect::POSTERIZE:
+                for (int x = 0; x < width; x++, row += stride) {
+                    for (int c = 0; c < NumChannels; c++) {
+                        row[c] = std::floor(row[c] * effect.amount + 0.5f) / effect.amount;
+                    }
+                }
+                return;
+        }
+    }
+
+    // Color channels come first in every layout, as for pixelate
+    template<int NumChannels>
+    void applyFloatEffectsImpl(const ofxGlic::kernels::FloatEffect* effects, size_t count, float* data, int width,
+                               int stride, int y0, int y1) {
+        for (int y = y0; y < y1; y++) {
+            float* row = data + size_t(y) * width * stride;
+            for (size_t i = 0; i < count; i++) {
+                applyFloatEffect<NumChannels>(effects[i], row, width, stride, y);
+            }
+        }
+    }
+}
+
+namespace ofxGlic {
+namespace kernels {
+
+bool getEffectLayout(ofPixelFormat format, EffectLayout& layout) {
+    switch (format) {
+        case OF_PIXELS_GRAY:       layout = {0, 0, 0, -1, 1}; return true;
+        case OF_PIXELS_GRAY_ALPHA: layout = {0, 0, 0, 1, 2}; return true;
+        case OF_PIXELS_RGB:        layout = {0, 1, 2, -1, 3}; return true;
+        case OF_PIXELS_BGR:        layout = {2, 1, 0, -1, 3}; return true;
+        case OF_PIXELS_RGBA:       layout = {0, 1, 2, 3, 4}; return true;
+        case OF_PIXELS_BGRA:       layout = {2, 1, 0, 3, 4}; return true;
+        default: return false;
+    }
+}
+
+void applyTable(const ofxGlicEffectTable& table, uint8_t* data, int width, const EffectLayout& layout,
+                int y0, int y1) {
+    RowKernel kernel = getRowKernel();
+    if (!kernel || (layout.isGray() && !table.preservesGray)) {
+        applyTableScalar(table, data, width, layout, y0, y1);
+        return;
+    }
+
+    // Rows of one phase share a program, so the band is walked phase by phase
+    const size_t rowSize = size_t(width) * layout.stride;
+    RowProgram program;
+    for (int phaseY = 0; phaseY < table.periodY; phaseY++) {
+        if (table.identityRows[phaseY]) continue;
+        int first = y0 + ((phaseY - y0 % table.periodY) + table.periodY) % table.periodY;
+        if (!table.vectorRows[phaseY]) {
+            for (int y = first; y < y1; y += table.periodY) applyTableScalar(table, data, width, layout, y, y + 1);
+            continue;
+        }
+        makeRowProgram(table, phaseY, layout, program);
+        for (int y = first; y < y1; y += table.periodY) {
+            uint8_t* row = data + size_t(y) * rowSize;
+            size_t done = kernel(program, row, rowSize);
+            applyTableBytes(table, phaseY, layout, row, done, rowSize);
+        }
+    }
+}
+
+size_t getPixelateSumsSize(int width, const EffectLayout& layout) {
+    return size_t(width + 1) * layout.stride;
+}
+
+void pixelate(uint8_t* data, int width, int height, const EffectLayout& layout, int blockWidth, int blockHeight,
+              int y0, int y1, uint32_t* sums) {
+    pixelateRegion(data, width, layout, 0, y0, width, std::min(height, y1), blockWidth, blockHeight, sums);
+}
+
+void pixelateRegion(uint8_t* data, int width, const EffectLayout& layout, int x0, int y0, int x1, int y1,
+                    int blockWidth, int blockHeight, uint32_t* sums) {
+    if (x1 <= x0 || y1 <= y0) return;
+    blockWidth = std::max(1, blockWidth);
+    blockHeight = std::max(1, blockHeight);
+    // A block of up to 255 * 16843009 < 2^32 fits in 32 bits
+    if (uint64_t(blockWidth) * uint64_t(blockHeight) <= 16843009u) {
+        pixelateLayout<uint8_t, uint32_t, true>(data, width, layout, x0, y0, x1, y1, blockWidth, blockHeight, sums);
+    } else {
+        pixelateLayout<uint8_t, uint32_t, false>(data, width, layout, x0, y0, x1, y1, blockWidth, blockHeight, sums);
+    }
+}
+
+void pixelate(float* data, int width, int height, const EffectLayout& layout, int blockWidth, int blockHeight,
+              int y0, int y1, double* sums) {
+    if (width <= 0 || y1 <= y0) return;
+    pixelateLayout<float, double, true>(data, width, layout, 0, y0, width, std::min(height, y1),
+                                        std::max(1, blockWidth), std::max(1, blockHeight), sums);
+}
+
+void copyColors(const uint8_t* src, uint8_t* dst, size_t count, const EffectLayout& layout) {
+    switch (layout.stride) {
+        case 1: std::copy(src, src + count, dst); break;
+        case 3: std::copy(src, src + count * 3, dst); break;
+        case 2:
+        case 4: copyColorRow(src, dst, count, layout.stride); break;
+        default: break;
+    }
+}
+
+void getChromaticHalo(int height, int offsetY, int y0, int y1, int& above, int& below) {
+    int reach = std::abs(offsetY);
+    above = y0 - std::max(0, y0 - reach);
+    below = std::min(height, y1 + reach) - y1;
+}
+
+void chromatic(uint8_t* data, int width, int height, const EffectLayout& layout, int offsetX, int offsetY,
+               int y0, int y1, const uint8_t* halo) {
+    chromaticImpl(data, width, height, layout, offsetX, offsetY, y0, y1, halo);
+}
+
+void chromatic(float* data, int width, int height, const EffectLayout& layout, int offsetX, int offsetY,
+               int y0, int y1, const float* halo) {
+    chromaticImpl(data, width, height, layout, offsetX, offsetY, y0, y1, halo);
+}
+
+void glitchShift(uint8_t* data, int width, int height, const EffectLayout& layout, int blockSize, uint32_t seed,
+                 int y0, int y1) {
+    glitchShiftImpl(data, width, height, layout, blockSize, seed, y0, y1);
+}
+
+void glitchShift(float* data, int width, int height, const EffectLayout& layout, int blockSize, uint32_t seed,
+                 int y0, int y1) {
+    glitchShiftImpl(data, width, height, layout, blockSize, seed, y0, y1);
+}
+
+void applyFloatEffects(const FloatEffect* effects, size_t count, float* data, int width, const EffectLayout& layout,
+                       int y0, int y1) {
+    if (layout.isGray()) {
+        applyFloatEffectsImpl<1>(effects, count, data, width, layout.stride, y0, y1);
+    } else {
+        applyFloatEffectsImpl<3>(effects, count, data, width, layout.stride, y0, y1);
+    }
+}
+
+}
+}
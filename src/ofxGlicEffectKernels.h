@@ -0,0 +1,129 @@
+#pragma once
+
+#include "ofMain.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-channel lookup table of one or more fused pointwise effects
+// A pixel's output depends on its own channel value and its position modulo
+// the period, which is 1, 2, 4 or 8 in each direction.
+struct ofxGlicEffectTable {
+    int periodX = 1;
+    int periodY = 1;
+    std::vector<uint8_t> values;     // [phaseY][phaseX][R, G, B, A][256]
+    std::vector<bool> identityRows;  // Per phaseY: leaves every pixel unchanged (e.g. between scanlines)
+    bool preservesGray = false;      // R, G and B map alike, so gray input stays gray
+
+    // Arithmetic form of one channel's table, which vector instructions can
+    // evaluate for many channels at once where a lookup cannot
+    struct Form {
+        enum Kind : uint8_t { NONE, ADD, SCALE, STEPS };
+        static const int maxSteps = 16;
+
+        Kind kind = NONE;
+        int offset = 0;      // ADD: clamp(v + offset)
+        uint16_t scale = 0;  // SCALE: clamp(((v * scale) >> 16) + offset)
+        uint8_t base = 0;    // STEPS: base plus the delta of every threshold <= v, modulo 256
+        int numSteps = 0;
+        uint8_t thresholds[maxSteps] = {};
+        uint8_t deltas[maxSteps] = {};
+    };
+    std::vector<Form> forms;        // [phaseY][phaseX][R, G, B, A]
+    std::vector<bool> vectorRows;   // Per phaseY: every channel has a form
+
+    uint8_t* at(int phaseX, int phaseY) { return &values[size_t(phaseY * periodX + phaseX) * 1024]; }
+    const uint8_t* at(int phaseX, int phaseY) const { return &values[size_t(phaseY * periodX + phaseX) * 1024]; }
+
+    // Call once the values are final
+    void analyze();
+};
+
+// Effect kernels behind ofxGlicEffects
+// Each kernel works in place on interleaved pixels, 8-bit or float, so
+// ofPixels and ofFloatPixels need no conversion to glic colors. On 8-bit
+// pixels scanline, dither and posterize take lookup tables measured from
+// glic (see ofxGlicEffectChain); table rows whose channels all have a Form
+// run on the best SIMD level (see ofxGlicSimd.h), with results identical to
+// the lookups. Float kernels do not clamp, so values outside [0, 1] stay
+// outside.
+// A call processes rows [y0, y1) of a width x height image, so bands of
+// one image can run on separate threads with identical results. Pixelate
+// and glitch shift bands must start at a multiple of the block height.
+
+namespace ofxGlic {
+namespace kernels {
+    // Element offset of each channel inside a pixel; gray formats have
+    // r == g == b and a channel the format lacks is -1
+    struct EffectLayout {
+        int r = 0;
+        int g = 1;
+        int b = 2;
+        int a = 3;
+        int stride = 4;
+
+        bool isGray() const { return r == g && g == b; }
+    };
+
+    // Layout of GRAY, GRAY_ALPHA, RGB, BGR, RGBA and BGRA; false for other formats
+    bool getEffectLayout(ofPixelFormat format, EffectLayout& layout);
+
+    // Gray pixels receive the brightest of the R, G and B results, as when
+    // gray ofPixels go through glic colors and back
+    void applyTable(const ofxGlicEffectTable& table, uint8_t* data, int width, const EffectLayout& layout,
+                    int y0, int y1);
+
+    // Each blockWidth x blockHeight block becomes the average of its pixels;
+    // alpha is kept. The rows of a block row are summed per column and turned
+    // into the last row of that block row's summed-area table, so a block
+    // costs two lookups per channel whatever its size; the block row's first
+    // row is filled and copied down. sums is scratch for
+    // getPixelateSumsSize(width, layout) values per band.
+    size_t getPixelateSumsSize(int width, const EffectLayout& layout);
+    void pixelate(uint8_t* data, int width, int height, const EffectLayout& layout, int blockWidth, int blockHeight,
+                  int y0, int y1, uint32_t* sums);
+    // Float averages are not truncated
+    void pixelate(float* data, int width, int height, const EffectLayout& layout, int blockWidth, int blockHeight,
+                  int y0, int y1, double* sums);
+
+    // Same for the rectangle [x0, x1) x [y0, y1) of an image width pixels
+    // wide: blocks start at its corner and are cut at its edges. sums needs
+    // getPixelateSumsSize(x1 - x0, layout) values.
+    void pixelateRegion(uint8_t* data, int width, const EffectLayout& layout, int x0, int y0, int x1, int y1,
+                        int blockWidth, int blockHeight, uint32_t* sums);
+
+    // Copy the color channels of count pixels and keep dst's alpha
+    void copyColors(const uint8_t* src, uint8_t* dst, size_t count, const EffectLayout& layout);
+
+    // Red is taken from (x - offsetX, y - offsetY) and blue from
+    // (x + offsetX, y + offsetY), clamped to the image; needs color pixels.
+    // A band reads up to |offsetY| rows of its neighbours, which other bands
+    // may already have changed: halo holds a copy of the `above` rows before
+    // y0 followed by the `below` rows from y1, taken before any band starts
+    // (nullptr when the band is the whole image).
+    void getChromaticHalo(int height, int offsetY, int y0, int y1, int& above, int& below);
+    void chromatic(uint8_t* data, int width, int height, const EffectLayout& layout, int offsetX, int offsetY,
+                   int y0, int y1, const uint8_t* halo);
+    void chromatic(float* data, int width, int height, const EffectLayout& layout, int offsetX, int offsetY,
+                   int y0, int y1, const float* halo);
+
+    // Block rows of blockSize rows picked by a seeded random sequence are
+    // rotated left by a random number of pixels, alpha included
+    void glitchShift(uint8_t* data, int width, int height, const EffectLayout& layout, int blockSize, uint32_t seed,
+                     int y0, int y1);
+    void glitchShift(float* data, int width, int height, const EffectLayout& layout, int blockSize, uint32_t seed,
+                     int y0, int y1);
+
+    // Float form of one pointwise effect, for the color channels
+    struct FloatEffect {
+        enum Kind : uint8_t { SCANLINE, DITHER, POSTERIZE };
+
+        Kind kind = SCANLINE;
+        float amount = 0;  // SCANLINE: factor of odd rows; DITHER: offset per Bayer level; POSTERIZE: steps
+    };
+
+    // effects one after the other, in a single pass
+    void applyFloatEffects(const FloatEffect* effects, size_t count, float* data, int width,
+                           const EffectLayout& layout, int y0, int y1);
+}
+}
@@ -1,5 +1,568 @@
 #include "ofxGlicEffects.h"
+#include "ofxGlicEffectKernels.h"
+#include "ofxGlicThreadPool.h"
 #include "glic/effects.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace {
+    const int maxPeriod = 8;
+
+    // Effects that may be pointwise; whether they really are is measured
+    bool isPointwiseCandidate(ofxGlicEffectType type) {
+        return type == ofxGlicEffectType::SCANLINE || type == ofxGlicEffectType::DITHER ||
+               type == ofxGlicEffectType::POSTERIZE;
+    }
+
+    // Channel offsets of a glic::Color in memory
+    ofxGlic::kernels::EffectLayout getColorLayout() {
+        glic::Color color = glic::makeColor(0, 1, 2, 3);
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&color);
+        int offsets[4];
+        for (int i = 0; i < 4; i++) {
+            offsets[bytes[i]] = i;
+        }
+        return {offsets[0], offsets[1], offsets[2], offsets[3], 4};
+    }
+
+    const ofxGlic::kernels::EffectLayout& colorLayout() {
+        static const ofxGlic::kernels::EffectLayout layout = getColorLayout();
+        return layout;
+    }
+
+    // Row bands of one frame, run in parallel on ofxGlicThreadPool::shared()
+    struct Bands {
+        int rows = 0;   // Rows per band; the last band may be shorter
+        int count = 1;
+    };
+
+    // Bands start at multiples of align, so pixelate blocks are never split; small frames use fewer bands than threads
+    Bands makeBands(int width, int height, int align, size_t numThreads) {
+        const size_t minBandPixels = 1 << 16;
+        Bands bands;
+        bands.rows = height;
+
+        size_t threads = numThreads > 0 ? numThreads : ofxGlicThreadPool::shared().getNumThreads() + 1;
+        size_t count = std::min(threads, size_t(width) * size_t(height) / minBandPixels);
+        if (count <= 1) return bands;
+
+        align = std::max(1, align);
+        int rows = int((height + count - 1) / count);
+        bands.rows = (rows + align - 1) / align * align;
+        bands.count = (height + bands.rows - 1) / bands.rows;
+        return bands;
+    }
+
+    // fn(band, y0, y1) for every band, on the calling thread when there is only one
+    template<typename F>
+    void forEachBand(const Bands& bands, int height, size_t numThreads, F&& fn) {
+        if (bands.count <= 1) {
+            fn(0, 0, height);
+            return;
+        }
+        ofxGlicThreadPool::shared().parallelFor(size_t(bands.count), [&](size_t band) {
+            int y0 = int(band) * bands.rows;
+            fn(band, y0, std::min(height, y0 + bands.rows));
+        }, numThreads);
+    }
+
+    void applyTable(const ofxGlicEffectTable& table, uint8_t* data, int width, int height,
+                    const ofxGlic::kernels::EffectLayout& layout, size_t numThreads) {
+        forEachBand(makeBands(width, height, 1, numThreads), height, numThreads, [&](size_t, int y0, int y1) {
+            ofxGlic::kernels::applyTable(table, data, width, layout, y0, y1);
+        });
+    }
+
+    void applyTable(const ofxGlicEffectTable& table, glic::Color* colors, int width, int height,
+                    size_t numThreads = 1) {
+        applyTable(table, reinterpret_cast<uint8_t*>(colors), width, height, colorLayout(), numThreads);
+    }
+
+    // Chromatic aberration reads |offsetY| rows across band borders, so
+    // each band's neighbouring rows are copied to a halo before any band runs.
+    // The halo must stay a small share of a band's rows, or copying it costs
+    // more than the extra threads save: large offsets get fewer bands, down
+    // to a single one without a halo.
+    template<typename T>
+    void applyChromatic(const ofxGlicEffect& effect, T* data, int width, int height,
+                        const ofxGlic::kernels::EffectLayout& layout, size_t numThreads,
+                        std::vector<uint8_t>& scratch) {
+        const int haloRows = 2 * std::min(height, std::abs(effect.offsetY));
+        const int maxHaloShare = 4;  // Band rows per halo row, at least
+        Bands bands = makeBands(width, height, 1, numThreads);
+        if (bands.count > 1 && haloRows * maxHaloShare > bands.rows) {
+            size_t maxBands = size_t(height / (haloRows * maxHaloShare));
+            bands = makeBands(width, height, 1, std::max(size_t(1), std::min(size_t(bands.count), maxBands)));
+        }
+        const size_t rowSize = size_t(width) * layout.stride;
+        const size_t haloSize = size_t(haloRows) * rowSize;
+        bool useHalo = bands.count > 1 && haloSize > 0;
+
+        T* halo = nullptr;
+        if (useHalo) {
+            scratch.resize(haloSize * bands.count * sizeof(T));
+            halo = reinterpret_cast<T*>(scratch.data());
+            forEachBand(bands, height, numThreads, [&](size_t band, int y0, int y1) {
+                int above, below;
+                ofxGlic::kernels::getChromaticHalo(height, effect.offsetY, y0, y1, above, below);
+                T* out = halo + band * haloSize;
+                out = std::copy(data + (y0 - above) * rowSize, data + y0 * rowSize, out);
+                std::copy(data + y1 * rowSize, data + (y1 + below) * rowSize, out);
+            });
+        }
+        forEachBand(bands, height, numThreads, [&](size_t band, int y0, int y1) {
+            const T* bandHalo = useHalo ? halo + band * haloSize : nullptr;
+            ofxGlic::kernels::chromatic(data, width, height, layout, effect.offsetX, effect.offsetY, y0, y1, bandHalo);
+        });
+    }
+
+    // Smallest period in each direction that describes the same table
+    void reducePeriod(ofxGlicEffectTable& table) {
+        auto repeats = [&](int px, int py) {
+            for (int y = 0; y < table.periodY; y++) {
+                for (int x = 0; x < table.periodX; x++) {
+                    if (std::memcmp(table.at(x, y), table.at(x % px, y % py), 1024) != 0) return false;
+                }
+            }
+            return true;
+        };
+        int px = 1, py = 1;
+        while (px < table.periodX && !repeats(px, table.periodY)) px *= 2;
+        while (py < table.periodY && !repeats(px, py)) py *= 2;
+
+        std::vector<uint8_t> values(size_t(px) * py * 1024);
+        for (int y = 0; y < py; y++) {
+            for (int x = 0; x < px; x++) {
+                std::memcpy(&values[size_t(y * px + x) * 1024], table.at(x, y), 1024);
+            }
+        }
+        table.periodX = px;
+        table.periodY = py;
+        table.values.swap(values);
+        table.analyze();
+    }
+
+    // Same pixels through glic and through the table?
+    bool tableMatches(const ofxGlicEffectTable& table, const glic::EffectConfig& config, int width, int height,
+                      uint32_t seed) {
+        std::vector<glic::Color> expected(size_t(width) * height);
+        for (auto& color : expected) {
+            seed = seed * 1664525u + 1013904223u;
+            color = glic::makeColor(seed >> 24, seed >> 16, seed >> 8, seed);
+        }
+        std::vector<glic::Color> actual = expected;
+        glic::applyEffect(expected, width, height, config);
+        applyTable(table, actual.data(), width, height);
+        return expected == actual;
+    }
+
+    // Table of a pointwise effect, measured from glic; nullptr if the effect
+    // is not pointwise with a period of at most 8
+    std::shared_ptr<ofxGlicEffectTable> measureTable(const ofxGlicEffect& effect) {
+        if (!isPointwiseCandidate(effect.type)) return nullptr;
+        glic::EffectConfig config = effect.toGlic();
+
+        // 16 x 16 blocks of 8 x 8 pixels; block i holds value i in every channel
+        const int size = 16 * maxPeriod;
+        std::vector<glic::Color> probe(size_t(size) * size);
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                uint8_t value = uint8_t((y / maxPeriod) * 16 + x / maxPeriod);
+                probe[size_t(y) * size + x] = glic::makeColor(value, value, value, value);
+            }
+        }
+        glic::applyEffect(probe, size, size, config);
+
+        auto table = std::make_shared<ofxGlicEffectTable>();
+        table->periodX = maxPeriod;
+        table->periodY = maxPeriod;
+        table->values.resize(size_t(maxPeriod) * maxPeriod * 1024);
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                int value = (y / maxPeriod) * 16 + x / maxPeriod;
+                uint8_t* t = table->at(x % maxPeriod, y % maxPeriod);
+                glic::Color color = probe[size_t(y) * size + x];
+                t[value] = glic::getR(color);
+                t[256 + value] = glic::getG(color);
+                t[512 + value] = glic::getB(color);
+                t[768 + value] = glic::getA(color);
+            }
+        }
+        reducePeriod(*table);
+
+        // Mixed channels and other frame sizes catch effects that are not
+        // per channel, not periodic or depend on the frame size
+        if (!tableMatches(*table, config, 67, 45, 1) || !tableMatches(*table, config, 1021, 37, 2)) {
+            return nullptr;
+        }
+        return table;
+    }
+
+    // Pixelate sums of 8-bit and float channels
+    template<typename T> struct PixelateSum;
+    template<> struct PixelateSum<uint8_t> { using type = uint32_t; };
+    template<> struct PixelateSum<float> { using type = double; };
+
+    // Every band sums its block rows into its own slice of scratch
+    template<typename T>
+    void applyPixelate(const ofxGlicEffect& effect, T* data, int width, int height,
+                       const ofxGlic::kernels::EffectLayout& layout, size_t numThreads,
+                       std::vector<uint8_t>& scratch) {
+        using Sum = typename PixelateSum<T>::type;
+        Bands bands = makeBands(width, height, effect.getBlockHeight(), numThreads);
+        const size_t sumsSize = ofxGlic::kernels::getPixelateSumsSize(width, layout);
+        scratch.resize(sumsSize * bands.count * sizeof(Sum));
+        Sum* sums = reinterpret_cast<Sum*>(scratch.data());
+        forEachBand(bands, height, numThreads, [&](size_t band, int y0, int y1) {
+            ofxGlic::kernels::pixelate(data, width, height, layout, effect.blockSize, effect.getBlockHeight(), y0, y1,
+                                       sums + band * sumsSize);
+        });
+    }
+
+    // Bands hold whole block rows, which move as one
+    template<typename T>
+    void applyGlitchShift(const ofxGlicEffect& effect, T* data, int width, int height,
+                          const ofxGlic::kernels::EffectLayout& layout, size_t numThreads) {
+        forEachBand(makeBands(width, height, effect.blockSize, numThreads), height, numThreads,
+                    [&](size_t, int y0, int y1) {
+            ofxGlic::kernels::glitchShift(data, width, height, layout, effect.blockSize, effect.seed, y0, y1);
+        });
+    }
+
+    // Native kernel of a spatial effect; false for the other effects
+    // scratch holds pixelate sums and chromatic aberration halos.
+    template<typename T>
+    bool applySpatial(const ofxGlicEffect& effect, T* data, int width, int height,
+                      const ofxGlic::kernels::EffectLayout& layout, size_t numThreads,
+                      std::vector<uint8_t>& scratch) {
+        switch (effect.type) {
+            case ofxGlicEffectType::PIXELATE:
+                applyPixelate(effect, data, width, height, layout, numThreads, scratch);
+                return true;
+            case ofxGlicEffectType::CHROMATIC_ABERRATION:
+                applyChromatic(effect, data, width, height, layout, numThreads, scratch);
+                return true;
+            case ofxGlicEffectType::GLITCH_SHIFT:
+                applyGlitchShift(effect, data, width, height, layout, numThreads);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Same RGBA pixels from the native kernel and through glic?
+    bool spatialMatches(const ofxGlicEffect& effect, int width, int height, uint32_t seed) {
+        ofPixels expected;
+        expected.allocate(width, height, OF_PIXELS_RGBA);
+        uint8_t* data = expected.getData();
+        for (size_t i = 0; i < expected.size(); i++) {
+            seed = seed * 1664525u + 1013904223u;
+            data[i] = uint8_t(seed >> 24);
+        }
+        ofPixels actual = expected;
+
+        std::vector<glic::Color> colors;
+        ofxGlic::toGlicColors(expected, colors);
+        glic::applyEffect(colors, width, height, effect.toGlic());
+        ofxGlic::toOfPixels(colors.data(), width, height, expected);
+
+        ofxGlic::kernels::EffectLayout layout;
+        ofxGlic::kernels::getEffectLayout(OF_PIXELS_RGBA, layout);
+        std::vector<uint8_t> scratch;
+        return applySpatial(effect, actual.getData(), width, height, layout, 1, scratch) &&
+               std::memcmp(expected.getData(), actual.getData(), expected.size()) == 0;
+    }
+
+    // Non-square pixelate blocks only exist in the native kernel
+    bool hasGlicCounterpart(const ofxGlicEffect& effect) {
+        return effect.type != ofxGlicEffectType::PIXELATE || effect.getBlockHeight() == effect.blockSize;
+    }
+
+    // Float form of a pointwise effect; false for the other effects
+    bool getFloatEffect(const ofxGlicEffect& effect, ofxGlic::kernels::FloatEffect& floatEffect) {
+        using FloatEffect = ofxGlic::kernels::FloatEffect;
+        switch (effect.type) {
+            case ofxGlicEffectType::SCANLINE:
+                floatEffect = {FloatEffect::SCANLINE, 1.0f - effect.intensity / 100.0f};
+                return true;
+            case ofxGlicEffectType::DITHER:
+                floatEffect = {FloatEffect::DITHER, effect.intensity / 50.0f / 255.0f};
+                return true;
+            case ofxGlicEffectType::POSTERIZE:
+                floatEffect = {FloatEffect::POSTERIZE, float(std::max(2, effect.levels) - 1)};
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Does the float form agree with the measured table on [0, 1]? glic
+    // truncates to 8 bits where the float form does not, so color channels
+    // may be one step apart; alpha must be left alone
+    bool floatEffectMatches(const ofxGlic::kernels::FloatEffect& floatEffect, const ofxGlicEffectTable& table) {
+        // Every 8-bit value at every phase of a period of 8
+        const int width = 256 * maxPeriod;
+        const int height = maxPeriod;
+        std::vector<float> probe(size_t(width) * height * 4);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                std::fill_n(&probe[(size_t(y) * width + x) * 4], 4, (x / maxPeriod) / 255.0f);
+            }
+        }
+        ofxGlic::kernels::EffectLayout layout;
+        ofxGlic::kernels::getEffectLayout(OF_PIXELS_RGBA, layout);
+        ofxGlic::kernels::applyFloatEffects(&floatEffect, 1, probe.data(), width, layout, 0, height);
+
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int value = x / maxPeriod;
+                const uint8_t* t = table.at(x % table.periodX, y % table.periodY);
+                const float* pixel = &probe[(size_t(y) * width + x) * 4];
+                for (int c = 0; c < 3; c++) {
+                    float scaled = std::min(1.0f, std::max(0.0f, pixel[c])) * 255.0f;
+                    if (std::fabs(scaled - t[c * 256 + value]) > 1.001f) return false;
+                }
+                if (t[768 + value] != value || pixel[3] != value / 255.0f) return false;
+            }
+        }
+        return true;
+    }
+
+    // How an effect runs on 8-bit and float pixels without glic
+    struct EffectKernel {
+        std::shared_ptr<const ofxGlicEffectTable> table;  // Pointwise effects
+        bool spatial = false;  // The native spatial kernel matches glic
+        bool hasFloatEffect = false;  // floatEffect agrees with table
+        ofxGlic::kernels::FloatEffect floatEffect;
+    };
+
+    // Measured once per distinct effect; like the chain cache, only a few
+    // recent effects are kept. Measuring runs glic on probe images, so it
+    // happens outside the lock
+    std::shared_ptr<const EffectKernel> getKernel(const ofxGlicEffect& effect) {
+        static std::mutex mutex;
+        static std::vector<std::pair<ofxGlicEffect, std::shared_ptr<const EffectKernel>>> kernels;  // Most recently used last
+        const size_t maxKernels = 32;
+
+        auto find = [&]() -> std::shared_ptr<const EffectKernel> {
+            for (auto it = kernels.begin(); it != kernels.end(); ++it) {
+                if (it->first == effect) {
+                    auto entry = std::move(*it);
+                    kernels.erase(it);
+                    kernels.push_back(std::move(entry));
+                    return kernels.back().second;
+                }
+            }
+            return nullptr;
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (auto kernel = find()) return kernel;
+        }
+
+        auto kernel = std::make_shared<EffectKernel>();
+        kernel->table = measureTable(effect);
+        if (!hasGlicCounterpart(effect)) {
+            kernel->spatial = true;
+        } else if (effect.type == ofxGlicEffectType::PIXELATE ||
+                   effect.type == ofxGlicEffectType::CHROMATIC_ABERRATION ||
+                   effect.type == ofxGlicEffectType::GLITCH_SHIFT) {
+            kernel->spatial = spatialMatches(effect, 67, 45, 1) && spatialMatches(effect, 1021, 37, 2);
+        }
+        kernel->hasFloatEffect = kernel->table && getFloatEffect(effect, kernel->floatEffect) &&
+                                 floatEffectMatches(kernel->floatEffect, *kernel->table);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto existing = find()) return existing;  // Measured by another thread meanwhile
+        if (kernels.size() >= maxKernels) {
+            kernels.erase(kernels.begin());
+        }
+        kernels.emplace_back(effect, std::move(kernel));
+        return kernels.back().second;
+    }
+
+    // first followed by second, as one table
+    std::shared_ptr<ofxGlicEffectTable> composeTables(const ofxGlicEffectTable& first, const ofxGlicEffectTable& second) {
+        auto table = std::make_shared<ofxGlicEffectTable>();
+        table->periodX = std::max(first.periodX, second.periodX);
+        table->periodY = std::max(first.periodY, second.periodY);
+        table->values.resize(size_t(table->periodX) * table->periodY * 1024);
+        for (int y = 0; y < table->periodY; y++) {
+            for (int x = 0; x < table->periodX; x++) {
+                const uint8_t* a = first.at(x % first.periodX, y % first.periodY);
+                const uint8_t* b = second.at(x % second.periodX, y % second.periodY);
+                uint8_t* t = table->at(x, y);
+                for (int i = 0; i < 1024; i++) {
+                    t[i] = b[(i & ~255) + a[i]];
+                }
+            }
+        }
+        table->analyze();
+        return table;
+    }
+}
+
+void ofxGlicEffectChain::setEffects(const std::vector<ofxGlicEffect>& effects) {
+    effects_ = effects;
+    stages_.clear();
+
+    for (const auto& effect : effects) {
+        if (effect.type == ofxGlicEffectType::NONE) continue;
+
+        std::shared_ptr<const EffectKernel> kernel = getKernel(effect);
+        if (kernel->table && !stages_.empty() && stages_.back().table) {
+            Stage& stage = stages_.back();
+            stage.table = composeTables(*stage.table, *kernel->table);
+            stage.floatNative = stage.floatNative && kernel->hasFloatEffect;
+            stage.floatEffects.push_back(kernel->floatEffect);
+        } else {
+            Stage stage;
+            stage.table = kernel->table;
+            stage.effect = effect;
+            stage.native = kernel->table || kernel->spatial;
+            stage.floatNative = kernel->table ? kernel->hasFloatEffect : kernel->spatial;
+            if (kernel->table) stage.floatEffects.push_back(kernel->floatEffect);
+            stages_.push_back(stage);
+        }
+    }
+}
+
+void ofxGlicEffectChain::apply(std::vector<glic::Color>& colors, int width, int height, size_t numThreads) const {
+    std::vector<uint8_t> scratch;
+    for (const auto& stage : stages_) {
+        if (stage.table) {
+            applyTable(*stage.table, colors.data(), width, height, numThreads);
+        } else if (!hasGlicCounterpart(stage.effect)) {
+            applySpatial(stage.effect, reinterpret_cast<uint8_t*>(colors.data()), width, height, colorLayout(),
+                         numThreads, scratch);
+        } else {
+            glic::applyEffect(colors, width, height, stage.effect.toGlic());
+        }
+    }
+}
+
+bool ofxGlicEffectChain::applyNative(ofPixels& pixels, ofxGlicWorkspace& workspace, size_t numThreads) const {
+    ofxGlic::kernels::EffectLayout layout;
+    if (!ofxGlic::kernels::getEffectLayout(pixels.getPixelFormat(), layout)) return false;
+
+    // Gray pixels hold one channel where glic sees three equal ones, so
+    // every stage but the last has to keep them equal
+    for (size_t i = 0; i < stages_.size(); i++) {
+        const Stage& stage = stages_[i];
+        if (!stage.native) return false;
+        if (layout.isGray()) {
+            if (stage.effect.type == ofxGlicEffectType::CHROMATIC_ABERRATION) return false;
+            if (stage.table && !stage.table->preservesGray && i + 1 < stages_.size()) return false;
+        }
+    }
+
+    int width = pixels.getWidth();
+    int height = pixels.getHeight();
+    ofxGlicWorkspace::Scope scope(workspace);
+    std::vector<uint8_t>& scratch = workspace.acquireBytes();
+    for (const auto& stage : stages_) {
+        if (stage.table) {
+            applyTable(*stage.table, pixels.getData(), width, height, layout, numThreads);
+        } else {
+            applySpatial(stage.effect, pixels.getData(), width, height, layout, numThreads, scratch);
+        }
+    }
+    return true;
+}
+
+void ofxGlicEffectChain::apply(ofPixels& pixels, ofxGlicWorkspace& workspace, size_t numThreads) const {
+    if (stages_.empty() || applyNative(pixels, workspace, numThreads)) return;
+
+    int width = pixels.getWidth();
+    int height = pixels.getHeight();
+
+    ofxGlicWorkspace::Scope scope(workspace);
+    std::vector<glic::Color>& colors = workspace.acquireColors(0);
+    ofxGlic::toGlicColors(pixels, colors);
+    apply(colors, width, height, numThreads);
+    ofxGlic::toOfPixels(colors.data(), width, height, pixels);
+}
+
+bool ofxGlicEffectChain::applyNative(ofFloatPixels& pixels, ofxGlicWorkspace& workspace, size_t numThreads) const {
+    ofxGlic::kernels::EffectLayout layout;
+    if (!ofxGlic::kernels::getEffectLayout(pixels.getPixelFormat(), layout)) return false;
+
+    // Float forms treat R, G and B alike, so gray only rules out chromatic aberration
+    for (const auto& stage : stages_) {
+        if (!stage.floatNative) return false;
+        if (layout.isGray() && stage.effect.type == ofxGlicEffectType::CHROMATIC_ABERRATION) return false;
+    }
+
+    int width = pixels.getWidth();
+    int height = pixels.getHeight();
+    ofxGlicWorkspace::Scope scope(workspace);
+    std::vector<uint8_t>& scratch = workspace.acquireBytes();
+    for (const auto& stage : stages_) {
+        if (stage.table) {
+            forEachBand(makeBands(width, height, 1, numThreads), height, numThreads, [&](size_t, int y0, int y1) {
+                ofxGlic::kernels::applyFloatEffects(stage.floatEffects.data(), stage.floatEffects.size(),
+                                                    pixels.getData(), width, layout, y0, y1);
+            });
+        } else {
+            applySpatial(stage.effect, pixels.getData(), width, height, layout, numThreads, scratch);
+        }
+    }
+    return true;
+}
+
+void ofxGlicEffectChain::apply(ofFloatPixels& pixels, ofxGlicWorkspace& workspace, size_t numThreads) const {
+    ofxGlic::kernels::EffectLayout layout;
+    if (stages_.empty() || !ofxGlic::kernels::getEffectLayout(pixels.getPixelFormat(), layout)) return;
+    if (applyNative(pixels, workspace, numThreads)) return;
+
+    // Some stage only runs through glic, which works on 8-bit colors
+    ofxGlicWorkspace::Scope scope(workspace);
+    const size_t count = pixels.size();
+    std::vector<uint8_t>& buffer = workspace.acquireBytes(count);
+    float* data = pixels.getData();
+    for (size_t i = 0; i < count; i++) {
+        buffer[i] = uint8_t(std::min(1.0f, std::max(0.0f, data[i])) * 255.0f + 0.5f);
+    }
+
+    ofPixels bytes;
+    bytes.setFromExternalPixels(buffer.data(), pixels.getWidth(), pixels.getHeight(), pixels.getPixelFormat());
+    apply(bytes, workspace, numThreads);
+
+    for (size_t i = 0; i < count; i++) {
+        data[i] = buffer[i] / 255.0f;
+    }
+}
+
+std::shared_ptr<const ofxGlicEffectChain> ofxGlicEffectChain::get(const std::vector<ofxGlicEffect>& effects) {
+    // Presets and GUI settings repeat, so a few recent lists are kept
+    static std::mutex mutex;
+    static std::vector<std::shared_ptr<const ofxGlicEffectChain>> chains;  // Most recently added last
+    const size_t maxChains = 32;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& chain : chains) {
+            if (chain->getEffects() == effects) return chain;
+        }
+    }
+
+    // Built outside the lock; a chain built twice by racing threads is
+    // only kept once
+    auto built = std::make_shared<const ofxGlicEffectChain>(effects);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& chain : chains) {
+        if (chain->getEffects() == effects) return chain;
+    }
+    if (chains.size() >= maxChains) {
+        chains.erase(chains.begin());
+    }
+    chains.push_back(std::move(built));
+    return chains.back();
+}
 
 void ofxGlicEffects::addEffect(const ofxGlicEffect& effect) {
     effects_.push_back(effect);
@@ -13,6 +576,10 @@ void ofxGlicEffects::addPixelate(int blockSize) {
     effects_.push_back(ofxGlicEffect::pixelate(blockSize));
 }
 
+void ofxGlicEffects::addPixelate(int blockWidth, int blockHeight) {
+    effects_.push_back(ofxGlicEffect::pixelate(blockWidth, blockHeight));
+}
+
 void ofxGlicEffects::addScanline(int intensity) {
     effects_.push_back(ofxGlicEffect::scanline(intensity));
 }
@@ -43,32 +610,21 @@ void ofxGlicEffects::apply(ofImage& image) {
 }
 
 void ofxGlicEffects::apply(ofPixels& pixels) {
-    int width = pixels.getWidth();
-    int height = pixels.getHeight();
+    if (effects_.empty()) return;
 
-    // Convert to glic::Color array
-    std::vector<glic::Color> colors(width * height);
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            ofColor c = pixels.getColor(x, y);
-            colors[idx] = glic::makeColor(c.r, c.g, c.b, c.a);
-        }
+    if (chain_.getEffects() != effects_) {
+        chain_.setEffects(effects_);
     }
+    chain_.apply(pixels, workspace(), numThreads_);
+}
 
-    // Apply each effect
-    for (const auto& effect : effects_) {
-        glic::applyEffect(colors, width, height, effect.toGlic());
-    }
+void ofxGlicEffects::apply(ofFloatPixels& pixels) {
+    if (effects_.empty()) return;
 
-    // Convert back to ofPixels
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            glic::Color c = colors[idx];
-            pixels.setColor(x, y, ofColor(glic::getR(c), glic::getG(c), glic::getB(c), glic::getA(c)));
-        }
+    if (chain_.getEffects() != effects_) {
+        chain_.setEffects(effects_);
     }
+    chain_.apply(pixels, workspace(), numThreads_);
 }
 
 ofImage ofxGlicEffects::process(const ofImage& source) {
@@ -84,30 +640,54 @@ void ofxGlicEffects::applyEffect(ofImage& image, const ofxGlicEffect& effect) {
 }
 
 void ofxGlicEffects::applyEffect(ofPixels& pixels, const ofxGlicEffect& effect) {
-    int width = pixels.getWidth();
-    int height = pixels.getHeight();
+    ofxGlicWorkspace workspace;
+    applyEffect(pixels, effect, workspace);
+}
 
-    // Convert to glic::Color array
-    std::vector<glic::Color> colors(width * height);
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            ofColor c = pixels.getColor(x, y);
-            colors[idx] = glic::makeColor(c.r, c.g, c.b, c.a);
-        }
-    }
+void ofxGlicEffects::applyEffect(ofPixels& pixels, const ofxGlicEffect& effect, ofxGlicWorkspace& workspace) {
+    applyEffects(pixels, {effect}, workspace);
+}
 
-    // Apply effect
-    glic::applyEffect(colors, width, height, effect.toGlic());
+void ofxGlicEffects::applyEffect(ofFloatPixels& pixels, const ofxGlicEffect& effect) {
+    ofxGlicWorkspace workspace;
+    applyEffect(pixels, effect, workspace);
+}
 
-    // Convert back to ofPixels
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            int idx = y * width + x;
-            glic::Color c = colors[idx];
-            pixels.setColor(x, y, ofColor(glic::getR(c), glic::getG(c), glic::getB(c), glic::getA(c)));
-        }
+void ofxGlicEffects::applyEffect(ofFloatPixels& pixels, const ofxGlicEffect& effect, ofxGlicWorkspace& workspace) {
+    applyEffects(pixels, {effect}, workspace);
+}
+
+void ofxGlicEffects::applyEffects(ofPixels& pixels, const std::vector<ofxGlicEffect>& effects,
+                                  ofxGlicWorkspace& workspace, size_t numThreads) {
+    if (effects.empty()) return;
+    ofxGlicEffectChain::get(effects)->apply(pixels, workspace, numThreads);
+}
+
+void ofxGlicEffects::applyEffects(ofFloatPixels& pixels, const std::vector<ofxGlicEffect>& effects,
+                                  ofxGlicWorkspace& workspace, size_t numThreads) {
+    if (effects.empty()) return;
+    ofxGlicEffectChain::get(effects)->apply(pixels, workspace, numThreads);
+}
+
+bool ofxGlicEffects::pixelateRegions(ofPixels& pixels, const std::vector<ofxGlicPixelateRegion>& regions,
+                                     ofxGlicWorkspace& workspace) {
+    ofxGlic::kernels::EffectLayout layout;
+    if (!ofxGlic::kernels::getEffectLayout(pixels.getPixelFormat(), layout)) return false;
+
+    // Each region sums its own block rows, as pixelate bands do, so no
+    // table of the whole frame is needed
+    int width = pixels.getWidth();
+    int height = pixels.getHeight();
+    ofxGlicWorkspace::Scope scope(workspace);
+    std::vector<uint8_t>& scratch = workspace.acquireBytes();
+    for (const auto& region : regions) {
+        int x0, y0, x1, y1;
+        if (!ofxGlic::clipRegion(region.area, width, height, x0, y0, x1, y1)) continue;
+        scratch.resize(ofxGlic::kernels::getPixelateSumsSize(x1 - x0, layout) * sizeof(uint32_t));
+        ofxGlic::kernels::pixelateRegion(pixels.getData(), width, layout, x0, y0, x1, y1, region.blockWidth,
+                                         region.blockHeight, reinterpret_cast<uint32_t*>(scratch.data()));
     }
+    return true;
 }
 
 std::string ofxGlicEffects::getEffectName(ofxGlicEffectType type) {
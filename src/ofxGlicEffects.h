@@ -2,6 +2,10 @@
 
 #include "ofMain.h"
 #include "glic/effects.hpp"
+#include "ofxGlicEffectKernels.h"
+#include "ofxGlicPixels.h"
+#include "ofxGlicWorkspace.h"
+#include <memory>
 #include <vector>
 
 // Convenience typedefs
@@ -12,6 +16,7 @@ struct ofxGlicEffect {
     ofxGlicEffectType type = ofxGlicEffectType::NONE;
     int intensity = 50;      // 0-100
     int blockSize = 8;       // For pixelate, glitch_shift
+    int blockHeight = 0;     // For pixelate with non-square blocks (0 = blockSize)
     int offsetX = 2;         // For chromatic aberration
     int offsetY = 0;         // For chromatic aberration
     int levels = 4;          // For posterize
@@ -33,6 +38,15 @@ struct ofxGlicEffect {
         return cfg;
     }
 
+    bool operator==(const ofxGlicEffect& other) const {
+        return type == other.type && intensity == other.intensity && blockSize == other.blockSize &&
+               blockHeight == other.blockHeight && offsetX == other.offsetX && offsetY == other.offsetY && levels == other.levels &&
+               seed == other.seed;
+    }
+    bool operator!=(const ofxGlicEffect& other) const { return !(*this == other); }
+
+    int getBlockHeight() const { return blockHeight > 0 ? blockHeight : blockSize; }
+
     // Factory methods for common effects
     static ofxGlicEffect pixelate(int blockSize = 8) {
         ofxGlicEffect e(ofxGlicEffectType::PIXELATE);
@@ -40,6 +54,13 @@ struct ofxGlicEffect {
         return e;
     }
 
+    // glic has no non-square pixelate, so these blocks always use the native kernel
+    static ofxGlicEffect pixelate(int blockWidth, int blockHeight) {
+        ofxGlicEffect e = pixelate(blockWidth);
+        e.blockHeight = blockHeight;
+        return e;
+    }
+
     static ofxGlicEffect scanline(int intensity = 50) {
         ofxGlicEffect e(ofxGlicEffectType::SCANLINE);
         e.intensity = intensity;
@@ -73,6 +94,68 @@ struct ofxGlicEffect {
     }
 };
 
+// Part of a frame pixelated with its own block size (see ofxGlicEffects::pixelateRegions)
+struct ofxGlicPixelateRegion {
+    ofRectangle area;
+    int blockWidth = 8;
+    int blockHeight = 8;
+};
+
+// Effect list prepared for repeated use
+// Runs of pointwise effects (scanline, dither, posterize) are fused into one
+// lookup-table pass. The tables are measured from glic::applyEffect on probe
+// images and checked against it, so the result is the same as applying the
+// effects one by one; an effect that does not fit a table runs through glic.
+// GRAY, GRAY_ALPHA, RGB, BGR, RGBA and BGRA pixels are processed in place
+// when every stage has a native kernel; pixelate, chromatic aberration and
+// glitch shift kernels are only used once they produced glic's result on
+// test images. Anything else converts to glic colors and back.
+// Float pixels of those formats have kernels of their own that keep values
+// outside [0, 1]. The float form of a pointwise effect is only used once it
+// agrees with the effect's measured table to within one 8-bit step.
+class ofxGlicEffectChain {
+public:
+    ofxGlicEffectChain() = default;
+    explicit ofxGlicEffectChain(const std::vector<ofxGlicEffect>& effects) { setEffects(effects); }
+
+    void setEffects(const std::vector<ofxGlicEffect>& effects);
+    const std::vector<ofxGlicEffect>& getEffects() const { return effects_; }
+
+    // In place when possible, otherwise converts to glic colors once for the whole chain
+    // Native and table stages are split into row bands on ofxGlicThreadPool::shared(),
+    // using at most numThreads threads including the caller (0 = all); the
+    // result does not depend on the thread count. Stages run through glic
+    // stay on the calling thread.
+    void apply(ofPixels& pixels, ofxGlicWorkspace& workspace, size_t numThreads = 1) const;
+    void apply(std::vector<glic::Color>& colors, int width, int height, size_t numThreads = 1) const;
+    // In place when every stage has a float kernel, otherwise rounded to 8
+    // bits in workspace, run like ofPixels and converted back, which clamps
+    // values to [0, 1]; unsupported formats are skipped
+    void apply(ofFloatPixels& pixels, ofxGlicWorkspace& workspace, size_t numThreads = 1) const;
+
+    // Full-frame passes per apply(), after fusing
+    size_t getNumPasses() const { return stages_.size(); }
+
+    // Shared chain for effects, compiled once per distinct list
+    static std::shared_ptr<const ofxGlicEffectChain> get(const std::vector<ofxGlicEffect>& effects);
+
+private:
+    struct Stage {
+        std::shared_ptr<const ofxGlicEffectTable> table;  // Fused stage when set
+        ofxGlicEffect effect;                // Otherwise run through glic
+        bool native = false;                 // Can run on ofPixels in place
+        bool floatNative = false;            // Can run on ofFloatPixels in place
+        std::vector<ofxGlic::kernels::FloatEffect> floatEffects;  // Float forms of a table's effects
+    };
+
+    // In place without conversion; false if some stage or the format needs glic
+    bool applyNative(ofPixels& pixels, ofxGlicWorkspace& workspace, size_t numThreads) const;
+    bool applyNative(ofFloatPixels& pixels, ofxGlicWorkspace& workspace, size_t numThreads) const;
+
+    std::vector<ofxGlicEffect> effects_;
+    std::vector<Stage> stages_;
+};
+
 // Effects processor class
 class ofxGlicEffects {
 public:
@@ -84,6 +167,7 @@ public:
 
     // Quick add methods
     void addPixelate(int blockSize = 8);
+    void addPixelate(int blockWidth, int blockHeight);
     void addScanline(int intensity = 50);
     void addChromatic(int offsetX = 2, int offsetY = 0);
     void addDither(int intensity = 50);
@@ -98,9 +182,20 @@ public:
     const std::vector<ofxGlicEffect>& getEffects() const { return effects_; }
     void setEffects(const std::vector<ofxGlicEffect>& effects) { effects_ = effects; }
 
+    // Most threads used per effect pass, including the calling thread (0 = all)
+    // Output does not depend on the thread count. Defaults to 1, as handing
+    // bands to the pool allocates a little for every pass.
+    void setNumThreads(size_t numThreads) { numThreads_ = numThreads; }
+    size_t getNumThreads() const { return numThreads_; }
+
+    // Scratch memory for conversion buffers and kernels (nullptr = the processor's own)
+    // A shared workspace must only be used from one thread at a time.
+    void setWorkspace(ofxGlicWorkspace* workspace) { externalWorkspace_ = workspace; }
+
     // Apply effects to image
     void apply(ofImage& image);
     void apply(ofPixels& pixels);
+    void apply(ofFloatPixels& pixels);
 
     // Apply effects and return new image
     ofImage process(const ofImage& source);
@@ -108,6 +203,24 @@ public:
     // Static helper to apply single effect
     static void applyEffect(ofImage& image, const ofxGlicEffect& effect);
     static void applyEffect(ofPixels& pixels, const ofxGlicEffect& effect);
+    static void applyEffect(ofPixels& pixels, const ofxGlicEffect& effect, ofxGlicWorkspace& workspace);
+    static void applyEffect(ofFloatPixels& pixels, const ofxGlicEffect& effect);
+    static void applyEffect(ofFloatPixels& pixels, const ofxGlicEffect& effect, ofxGlicWorkspace& workspace);
+
+    // Static helper to apply a list of effects, e.g. a preset's
+    // Converts once and fuses pointwise effects (see ofxGlicEffectChain).
+    static void applyEffects(ofPixels& pixels, const std::vector<ofxGlicEffect>& effects, ofxGlicWorkspace& workspace,
+                             size_t numThreads = 1);
+    static void applyEffects(ofFloatPixels& pixels, const std::vector<ofxGlicEffect>& effects,
+                             ofxGlicWorkspace& workspace, size_t numThreads = 1);
+
+    // Pixelate each region with its own block size, in order, so a region
+    // averages the pixels as the regions before it left them. Blocks start
+    // at the region's corner and are cut at its edges; alpha is kept. Only
+    // a row of column sums per region is kept in workspace. False for
+    // formats other than GRAY, GRAY_ALPHA, RGB, BGR, RGBA and BGRA.
+    static bool pixelateRegions(ofPixels& pixels, const std::vector<ofxGlicPixelateRegion>& regions,
+                                ofxGlicWorkspace& workspace);
 
     // Get effect name
     static std::string getEffectName(ofxGlicEffectType type);
@@ -117,4 +230,10 @@ public:
 
 private:
     std::vector<ofxGlicEffect> effects_;
+    ofxGlicEffectChain chain_;  // Compiled from effects_, rebuilt when they change
+    size_t numThreads_ = 1;
+    ofxGlicWorkspace& workspace() { return externalWorkspace_ ? *externalWorkspace_ : ownWorkspace_; }
+
+    ofxGlicWorkspace ownWorkspace_;  // Holds the conversion buffer between apply() calls
+    ofxGlicWorkspace* externalWorkspace_ = nullptr;
 };
@@ -0,0 +1,377 @@
+#include "ofxGlicFrameWriter.h"
+#include <cstring>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #include <sys/stat.h>
+#else
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    const char* frameHeader = "FRAME\n";
+    const size_t frameHeaderSize = 6;
+
+    // One row of frame as RGBA bytes
+    void readRow(const ofPixels& frame, int y, uint8_t* rgba) {
+        int width = int(frame.getWidth());
+        size_t channels = frame.getNumChannels();
+        const uint8_t* row = frame.getData() + size_t(y) * width * channels;
+
+        int r = 0, g = 1, b = 2, a = -1;
+        switch (frame.getPixelFormat()) {
+            case OF_PIXELS_GRAY:       r = g = b = 0; break;
+            case OF_PIXELS_GRAY_ALPHA: r = g = b = 0; a = 1; break;
+            case OF_PIXELS_RGB:        break;
+            case OF_PIXELS_BGR:        r = 2; b = 0; break;
+            case OF_PIXELS_RGBA:       a = 3; break;
+            case OF_PIXELS_BGRA:       r = 2; b = 0; a = 3; break;
+            default:
+                for (int x = 0; x < width; x++) {
+                    ofColor c = frame.getColor(x, y);
+                    rgba[x * 4 + 0] = c.r;
+                    rgba[x * 4 + 1] = c.g;
+                    rgba[x * 4 + 2] = c.b;
+                    rgba[x * 4 + 3] = c.a;
+                }
+                return;
+        }
+
+        for (int x = 0; x < width; x++, row += channels, rgba += 4) {
+            rgba[0] = row[r];
+            rgba[1] = row[g];
+            rgba[2] = row[b];
+            rgba[3] = a >= 0 ? row[a] : 255;
+        }
+    }
+
+    // BT.601 limited range, 8-bit fixed point
+    inline uint8_t lumaOf(int r, int g, int b) {
+        return uint8_t(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+    }
+    inline uint8_t cbOf(int r, int g, int b) {
+        return uint8_t(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+    }
+    inline uint8_t crOf(int r, int g, int b) {
+        return uint8_t(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+}
+
+ofxGlicFrameWriter::~ofxGlicFrameWriter() {
+    close();
+}
+
+size_t ofxGlicFrameWriter::getFrameSize(ofxGlicFrameFormat format, int width, int height) {
+    size_t pixels = size_t(width) * height;
+    switch (format) {
+        case ofxGlicFrameFormat::Y4M:    return pixels * 3;
+        case ofxGlicFrameFormat::Y4M420: return pixels + 2 * size_t((width + 1) / 2) * ((height + 1) / 2);
+        case ofxGlicFrameFormat::RGBA:   return pixels * 4;
+    }
+    return 0;
+}
+
+std::string ofxGlicFrameWriter::getExtension(ofxGlicFrameFormat format) {
+    return format == ofxGlicFrameFormat::RGBA ? "rgba" : "y4m";
+}
+
+bool ofxGlicFrameWriter::open(const std::string& path, int width, int height,
+                              const ofxGlicFrameWriterSettings& settings) {
+    close();
+    setError("");
+
+    if (width <= 0 || height <= 0) {
+        setError("Frame size must be positive");
+        return false;
+    }
+    if (settings.frameRateNum <= 0 || settings.frameRateDen <= 0) {
+        setError("Frame rate must be positive");
+        return false;
+    }
+
+    if (path == "-") {
+        file_ = stdout;
+        ownsFile_ = false;
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    } else {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            setError("Cannot open " + path);
+            return false;
+        }
+        ownsFile_ = true;
+        // Writes are already collected into large blocks
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+    }
+
+#ifdef _WIN32
+    struct _stat st;
+    regularFile_ = _fstat(_fileno(file_), &st) == 0 && (st.st_mode & _S_IFREG);
+#else
+    struct stat st;
+    regularFile_ = fstat(fileno(file_), &st) == 0 && S_ISREG(st.st_mode);
+#endif
+
+    settings_ = settings;
+    settings_.queueSize = std::max<size_t>(1, settings.queueSize);
+    width_ = width;
+    height_ = height;
+    numFrames_ = 0;
+    bytesWritten_ = 0;
+    framesSinceSync_ = 0;
+    stopping_ = false;
+    failed_ = false;
+    buffer_.clear();
+    buffer_.reserve(settings_.bufferSize);
+
+    if (settings_.format != ofxGlicFrameFormat::RGBA) {
+        std::string header = "YUV4MPEG2 W" + ofToString(width) + " H" + ofToString(height) +
+                             " F" + ofToString(settings_.frameRateNum) + ":" + ofToString(settings_.frameRateDen) +
+                             " Ip A1:1 " + (settings_.format == ofxGlicFrameFormat::Y4M ? "C444" : "C420jpeg") + "\n";
+        append(reinterpret_cast<const uint8_t*>(header.data()), header.size());
+    }
+
+    if (settings_.async) {
+        thread_ = std::thread(&ofxGlicFrameWriter::writerLoop, this);
+    }
+    return true;
+}
+
+bool ofxGlicFrameWriter::write(const ofPixels& frame) {
+    if (!file_) {
+        setError("Writer is not open");
+        return false;
+    }
+    if (int(frame.getWidth()) != width_ || int(frame.getHeight()) != height_) {
+        setError("Frame size must match the size given to open()");
+        return false;
+    }
+
+    if (!settings_.async) {
+        convert(frame, converted_);
+        numFrames_++;
+        return writeConverted(converted_);
+    }
+
+    std::vector<uint8_t> bytes;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        queueSpace_.wait(lock, [this] { return failed_ || queue_.size() < settings_.queueSize; });
+        if (failed_) return false;
+        if (!freeBuffers_.empty()) {
+            bytes = std::move(freeBuffers_.back());
+            freeBuffers_.pop_back();
+        }
+    }
+
+    convert(frame, bytes);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(bytes));
+    }
+    queueReady_.notify_one();
+    numFrames_++;
+    return true;
+}
+
+bool ofxGlicFrameWriter::close() {
+    if (!file_) return true;
+
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        queueReady_.notify_all();
+        thread_.join();
+    }
+
+    bool ok = !failed_ && flush();
+    if (ok && settings_.syncInterval > 0 && framesSinceSync_ > 0) {
+        ok = sync();
+    }
+    if (ownsFile_) {
+        if (std::fclose(file_) != 0 && ok) {
+            setError("Closing the file failed");
+            ok = false;
+        }
+    } else {
+        std::fflush(file_);
+    }
+
+    file_ = nullptr;
+    queue_.clear();
+    buffer_ = std::vector<uint8_t>();
+    return ok;
+}
+
+void ofxGlicFrameWriter::convert(const ofPixels& frame, std::vector<uint8_t>& out) {
+    size_t header = settings_.format == ofxGlicFrameFormat::RGBA ? 0 : frameHeaderSize;
+    out.resize(header + getFrameSize(settings_.format, width_, height_));
+    std::memcpy(out.data(), frameHeader, header);
+    uint8_t* dst = out.data() + header;
+
+    if (settings_.format == ofxGlicFrameFormat::RGBA) {
+        if (frame.getPixelFormat() == OF_PIXELS_RGBA) {
+            std::memcpy(dst, frame.getData(), out.size());
+            return;
+        }
+        for (int y = 0; y < height_; y++) {
+            readRow(frame, y, dst + size_t(y) * width_ * 4);
+        }
+        return;
+    }
+
+    size_t planeSize = size_t(width_) * height_;
+    std::vector<uint8_t>& rows = rows_;
+    rows.resize(size_t(width_) * 4 * 2);
+    uint8_t* luma = dst;
+
+    if (settings_.format == ofxGlicFrameFormat::Y4M) {
+        uint8_t* cb = dst + planeSize;
+        uint8_t* cr = cb + planeSize;
+        for (int y = 0; y < height_; y++) {
+            readRow(frame, y, rows.data());
+            const uint8_t* p = rows.data();
+            size_t offset = size_t(y) * width_;
+            for (int x = 0; x < width_; x++, p += 4) {
+                luma[offset + x] = lumaOf(p[0], p[1], p[2]);
+                cb[offset + x] = cbOf(p[0], p[1], p[2]);
+                cr[offset + x] = crOf(p[0], p[1], p[2]);
+            }
+        }
+        return;
+    }
+
+    // 4:2:0: chroma of each 2x2 block from its average color, edges clipped
+    int chromaWidth = (width_ + 1) / 2;
+    int chromaHeight = (height_ + 1) / 2;
+    uint8_t* cb = dst + planeSize;
+    uint8_t* cr = cb + size_t(chromaWidth) * chromaHeight;
+    for (int cy = 0; cy < chromaHeight; cy++) {
+        int y0 = cy * 2;
+        int numRows = std::min(2, height_ - y0);
+        for (int r = 0; r < numRows; r++) {
+            uint8_t* row = rows.data() + size_t(r) * width_ * 4;
+            readRow(frame, y0 + r, row);
+            uint8_t* lumaRow = luma + size_t(y0 + r) * width_;
+            for (int x = 0; x < width_; x++) {
+                lumaRow[x] = lumaOf(row[x * 4], row[x * 4 + 1], row[x * 4 + 2]);
+            }
+        }
+        for (int cx = 0; cx < chromaWidth; cx++) {
+            int x0 = cx * 2;
+            int numCols = std::min(2, width_ - x0);
+            int r = 0, g = 0, b = 0;
+            for (int dy = 0; dy < numRows; dy++) {
+                const uint8_t* p = rows.data() + size_t(dy) * width_ * 4 + x0 * 4;
+                for (int dx = 0; dx < numCols; dx++, p += 4) {
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+            }
+            int n = numRows * numCols;
+            r = (r + n / 2) / n;
+            g = (g + n / 2) / n;
+            b = (b + n / 2) / n;
+            cb[size_t(cy) * chromaWidth + cx] = cbOf(r, g, b);
+            cr[size_t(cy) * chromaWidth + cx] = crOf(r, g, b);
+        }
+    }
+}
+
+bool ofxGlicFrameWriter::append(const uint8_t* data, size_t size) {
+    if (buffer_.size() + size > settings_.bufferSize && !flush()) {
+        return false;
+    }
+    // Blocks at least as large as the buffer skip it
+    if (size >= settings_.bufferSize) {
+        if (std::fwrite(data, 1, size, file_) != size) {
+            setError("Write failed");
+            return false;
+        }
+        bytesWritten_ += size;
+        return true;
+    }
+    buffer_.insert(buffer_.end(), data, data + size);
+    return true;
+}
+
+bool ofxGlicFrameWriter::flush() {
+    if (!buffer_.empty()) {
+        if (std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size()) {
+            setError("Write failed");
+            return false;
+        }
+        bytesWritten_ += buffer_.size();
+        buffer_.clear();
+    }
+    if (!ownsFile_) {
+        std::fflush(file_);
+    }
+    return true;
+}
+
+bool ofxGlicFrameWriter::sync() {
+    framesSinceSync_ = 0;
+    if (!regularFile_) return true;
+#ifdef _WIN32
+    bool ok = _commit(_fileno(file_)) == 0;
+#else
+    bool ok = fsync(fileno(file_)) == 0;
+#endif
+    if (!ok) setError("Sync failed");
+    return ok;
+}
+
+bool ofxGlicFrameWriter::writeConverted(const std::vector<uint8_t>& bytes) {
+    if (!append(bytes.data(), bytes.size())) return false;
+    // Syncing in batches bounds what a crash can lose without paying for
+    // a sync on every frame
+    if (settings_.syncInterval > 0 && ++framesSinceSync_ >= settings_.syncInterval) {
+        return flush() && sync();
+    }
+    return true;
+}
+
+void ofxGlicFrameWriter::writerLoop() {
+    while (true) {
+        std::vector<uint8_t> bytes;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queueReady_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) break;
+            bytes = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        bool ok = writeConverted(bytes);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            freeBuffers_.push_back(std::move(bytes));
+            if (!ok) {
+                failed_ = true;
+                queue_.clear();
+            }
+        }
+        queueSpace_.notify_all();
+        if (!ok) break;
+    }
+}
+
+std::string ofxGlicFrameWriter::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastError_;
+}
+
+void ofxGlicFrameWriter::setError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastError_ = error;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ofMain.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class ofxGlicFrameFormat {
+    Y4M,     // YUV4MPEG2, 4:4:4 (BT.601, limited range); read by ffmpeg and most players
+    Y4M420,  // YUV4MPEG2, 4:2:0; half the size of 4:4:4, what most video encoders take
+    RGBA     // Raw 8-bit RGBA, no header (ffmpeg -f rawvideo -pix_fmt rgba -s WxH)
+};
+
+struct ofxGlicFrameWriterSettings {
+    ofxGlicFrameFormat format = ofxGlicFrameFormat::Y4M;
+    int frameRateNum = 30;             // Frame rate as a fraction, written to the Y4M header
+    int frameRateDen = 1;
+    size_t bufferSize = 4 << 20;       // Bytes collected before one large write
+    bool async = false;                // Write on a thread of its own; write() only converts
+    size_t queueSize = 4;              // Frames waiting for the async thread
+    int syncInterval = 0;              // fsync every this many frames (0 = never); regular files only
+};
+
+// Streams frames of one size to a single file, stdout or a named pipe
+// Frames are converted into a large buffer and written sequentially, which
+// is much cheaper than compressing one image file per frame. "-" as path
+// writes to stdout, e.g. for piping into ffmpeg:
+//   ./myApp | ffmpeg -i - -c:v libx264 out.mp4
+class ofxGlicFrameWriter {
+public:
+    ofxGlicFrameWriter() = default;
+    ~ofxGlicFrameWriter();
+
+    ofxGlicFrameWriter(const ofxGlicFrameWriter&) = delete;
+    ofxGlicFrameWriter& operator=(const ofxGlicFrameWriter&) = delete;
+
+    // Opening a named pipe blocks until the reader opens it
+    bool open(const std::string& path, int width, int height,
+              const ofxGlicFrameWriterSettings& settings = ofxGlicFrameWriterSettings());
+
+    // Frames must have the size given to open(); RGB, RGBA and grayscale are accepted
+    // In async mode this blocks while the queue is full and reports earlier write errors.
+    bool write(const ofPixels& frame);
+
+    // Write what is buffered, sync if syncInterval is set, and close
+    bool close();
+
+    bool isOpen() const { return file_ != nullptr; }
+    // A copy, since the async writer thread may set it at any time
+    std::string getLastError() const;
+    uint64_t getNumFrames() const { return numFrames_; }
+    uint64_t getBytesWritten() const { return bytesWritten_; }
+
+    // Bytes of one frame in format, without the Y4M frame header
+    static size_t getFrameSize(ofxGlicFrameFormat format, int width, int height);
+    // File extension for format ("y4m" or "rgba")
+    static std::string getExtension(ofxGlicFrameFormat format);
+
+private:
+    // Convert frame into out, including the Y4M frame header
+    void convert(const ofPixels& frame, std::vector<uint8_t>& out);
+    bool append(const uint8_t* data, size_t size);
+    bool flush();
+    bool sync();
+    bool writeConverted(const std::vector<uint8_t>& bytes);
+    void writerLoop();
+    void setError(const std::string& error);
+
+    std::FILE* file_ = nullptr;
+    bool ownsFile_ = false;     // false for stdout
+    bool regularFile_ = false;  // fsync only applies to files on disk
+    ofxGlicFrameWriterSettings settings_;
+    int width_ = 0;
+    int height_ = 0;
+    uint64_t numFrames_ = 0;
+    std::atomic<uint64_t> bytesWritten_{0};
+    int framesSinceSync_ = 0;
+    std::string lastError_;  // Guarded by mutex_
+
+    std::vector<uint8_t> buffer_;     // Pending bytes, written once bufferSize is reached
+    std::vector<uint8_t> converted_;  // Conversion scratch in sync mode
+    std::vector<uint8_t> rows_;       // Two RGBA rows being converted
+
+    // Async mode
+    std::thread thread_;
+    std::deque<std::vector<uint8_t>> queue_;
+    std::vector<std::vector<uint8_t>> freeBuffers_;  // Recycled so frames keep their allocation
+    bool stopping_ = false;
+    bool failed_ = false;
+    mutable std::mutex mutex_;
+    std::condition_variable queueReady_;
+    std::condition_variable queueSpace_;
+};
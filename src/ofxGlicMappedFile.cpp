@@ -0,0 +1,93 @@
+#include "ofxGlicMappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+ofxGlicMappedFile::~ofxGlicMappedFile() {
+    close();
+}
+
+bool ofxGlicMappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if (view) {
+                    file_ = file;
+                    mapping_ = mapping;
+                    data_ = static_cast<const uint8_t*>(view);
+                    size_ = size_t(fileSize.QuadPart);
+                    mapped_ = true;
+                    return true;
+                }
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* view = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED) {
+                // The descriptor is not needed once the mapping exists
+                ::close(fd);
+                madvise(view, size_t(st.st_size), MADV_SEQUENTIAL);
+                data_ = static_cast<const uint8_t*>(view);
+                size_ = size_t(st.st_size);
+                mapped_ = true;
+                return true;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    // Empty files, pipes and file systems without mmap support
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) return false;
+    fallback_.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    if (fallback_.empty()) return false;
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+    return true;
+}
+
+void ofxGlicMappedFile::close() {
+    if (mapped_) {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = nullptr;
+#else
+        munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    fallback_.clear();
+    fallback_.shrink_to_fit();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file
+// Memory-maps the file where the platform allows it, so pages are only read
+// when touched; otherwise falls back to reading it into memory.
+class ofxGlicMappedFile {
+public:
+    ofxGlicMappedFile() = default;
+    explicit ofxGlicMappedFile(const std::string& path) { open(path); }
+    ~ofxGlicMappedFile();
+
+    ofxGlicMappedFile(const ofxGlicMappedFile&) = delete;
+    ofxGlicMappedFile& operator=(const ofxGlicMappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    bool isMapped() const { return mapped_; }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<uint8_t> fallback_;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
@@ -0,0 +1,270 @@
+#include "ofxGlicPixelKernels.h"
+#include "ofxGlicSimd.h"
+
+#if defined(OFXGLIC_SIMD_X86)
+    #include <immintrin.h>
+#endif
+#if defined(OFXGLIC_SIMD_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace {
+    // Scalar versions, also used for the tails of the vector loops
+
+    void shuffle4Scalar(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+        const int o0 = order[0], o1 = order[1], o2 = order[2], o3 = order[3];
+        for (size_t i = 0; i < count; i++, src += 4, dst += 4) {
+            uint8_t b0 = src[o0], b1 = src[o1], b2 = src[o2], b3 = src[o3];
+            dst[0] = b0;
+            dst[1] = b1;
+            dst[2] = b2;
+            dst[3] = b3;
+        }
+    }
+
+    void expand3to4Scalar(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+        // Slot 3 of the pixel holds the opaque alpha
+        int o[4];
+        for (int k = 0; k < 4; k++) o[k] = order[k] < 0 ? 3 : order[k];
+
+        uint8_t px[4] = {0, 0, 0, 255};
+        for (size_t i = 0; i < count; i++, src += 3, dst += 4) {
+            px[0] = src[0];
+            px[1] = src[1];
+            px[2] = src[2];
+            dst[0] = px[o[0]];
+            dst[1] = px[o[1]];
+            dst[2] = px[o[2]];
+            dst[3] = px[o[3]];
+        }
+    }
+
+    void shrink4to3Scalar(const uint8_t* src, uint8_t* dst, size_t count, const int order[3]) {
+        const int o0 = order[0], o1 = order[1], o2 = order[2];
+        for (size_t i = 0; i < count; i++, src += 4, dst += 3) {
+            dst[0] = src[o0];
+            dst[1] = src[o1];
+            dst[2] = src[o2];
+        }
+    }
+
+#if defined(OFXGLIC_SIMD_X86)
+    // SSE2 has no byte shuffle, so move the bytes of each 32-bit pixel with shifts
+    OFXGLIC_TARGET("sse2")
+    void shuffle4Sse2(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+        const __m128i lowByte = _mm_set1_epi32(0xFF);
+        const __m128i in0 = _mm_cvtsi32_si128(order[0] * 8);
+        const __m128i in1 = _mm_cvtsi32_si128(order[1] * 8);
+        const __m128i in2 = _mm_cvtsi32_si128(order[2] * 8);
+        const __m128i in3 = _mm_cvtsi32_si128(order[3] * 8);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            __m128i b0 = _mm_and_si128(_mm_srl_epi32(v, in0), lowByte);
+            __m128i b1 = _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(v, in1), lowByte), 8);
+            __m128i b2 = _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(v, in2), lowByte), 16);
+            __m128i b3 = _mm_slli_epi32(_mm_srl_epi32(v, in3), 24);
+            __m128i out = _mm_or_si128(_mm_or_si128(b0, b1), _mm_or_si128(b2, b3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), out);
+        }
+        shuffle4Scalar(src + i * 4, dst + i * 4, count - i, order);
+    }
+
+    OFXGLIC_TARGET("ssse3")
+    void shuffle4Ssse3(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+        alignas(16) uint8_t table[16];
+        for (int i = 0; i < 16; i++) table[i] = uint8_t((i & ~3) + order[i & 3]);
+        const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(v, mask));
+        }
+        shuffle4Scalar(src + i * 4, dst + i * 4, count - i, order);
+    }
+
+    OFXGLIC_TARGET("ssse3")
+    void expand3to4Ssse3(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+        alignas(16) uint8_t table[16];
+        alignas(16) uint8_t fill[16];
+        for (int i = 0; i < 16; i++) {
+            int k = i & 3;
+            table[i] = order[k] < 0 ? 0x80 : uint8_t((i >> 2) * 3 + order[k]);
+            fill[i] = order[k] < 0 ? 0xFF : 0x00;
+        }
+        const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+        const __m128i alpha = _mm_load_si128(reinterpret_cast<const __m128i*>(fill));
+
+        // Each step reads 16 bytes for 4 pixels (12 bytes), so stop 2 pixels early
+        size_t i = 0;
+        for (; i + 6 <= count; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            v = _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), v);
+        }
+        expand3to4Scalar(src + i * 3, dst + i * 4, count - i, order);
+    }
+
+    OFXGLIC_TARGET("ssse3")
+    void shrink4to3Ssse3(const uint8_t* src, uint8_t* dst, size_t count, const int order[3]) {
+        alignas(16) uint8_t table[16];
+        for (int i = 0; i < 16; i++) {
+            table[i] = i < 12 ? uint8_t((i / 3) * 4 + order[i % 3]) : 0x80;
+        }
+        const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(table));
+
+        // Each step writes 16 bytes for 4 pixels (12 bytes), so stop 2 pixels early
+        size_t i = 0;
+        for (; i + 6 <= count; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3), _mm_shuffle_epi8(v, mask));
+        }
+        shrink4to3Scalar(src + i * 4, dst + i * 3, count - i, order);
+    }
+
+    OFXGLIC_TARGET("avx2")
+    void shuffle4Avx2(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+        alignas(32) uint8_t table[32];
+        for (int i = 0; i < 32; i++) table[i] = uint8_t((i & 0x0C) + order[i & 3]);
+        const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(table));
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(v, mask));
+        }
+        shuffle4Scalar(src + i * 4, dst + i * 4, count - i, order);
+    }
+
+    OFXGLIC_TARGET("avx2")
+    void expand3to4Avx2(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+        // Same 4-pixel pattern in both 128-bit lanes
+        alignas(32) uint8_t table[32];
+        alignas(32) uint8_t fill[32];
+        for (int i = 0; i < 32; i++) {
+            int k = i & 3;
+            table[i] = order[k] < 0 ? 0x80 : uint8_t(((i & 15) >> 2) * 3 + order[k]);
+            fill[i] = order[k] < 0 ? 0xFF : 0x00;
+        }
+        const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(table));
+        const __m256i alpha = _mm256_load_si256(reinterpret_cast<const __m256i*>(fill));
+
+        // Lane 1 reads 16 bytes at offset 12, so stop 2 pixels early
+        size_t i = 0;
+        for (; i + 10 <= count; i += 8) {
+            const uint8_t* s = src + i * 3;
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 12));
+            __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+            v = _mm256_or_si256(_mm256_shuffle_epi8(v, mask), alpha);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), v);
+        }
+        expand3to4Scalar(src + i * 3, dst + i * 4, count - i, order);
+    }
+
+    OFXGLIC_TARGET("avx2")
+    void shrink4to3Avx2(const uint8_t* src, uint8_t* dst, size_t count, const int order[3]) {
+        alignas(32) uint8_t table[32];
+        for (int i = 0; i < 32; i++) {
+            int j = i & 15;
+            table[i] = j < 12 ? uint8_t((j / 3) * 4 + order[j % 3]) : 0x80;
+        }
+        const __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(table));
+
+        // The second 16-byte store ends 4 bytes past the 8 pixels, so stop 2 pixels early
+        size_t i = 0;
+        for (; i + 10 <= count; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+            v = _mm256_shuffle_epi8(v, mask);
+            uint8_t* d = dst + i * 3;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm256_castsi256_si128(v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 12), _mm256_extracti128_si256(v, 1));
+        }
+        shrink4to3Scalar(src + i * 4, dst + i * 3, count - i, order);
+    }
+#endif
+
+#if defined(OFXGLIC_SIMD_NEON)
+    void shuffle4Neon(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            uint8x16x4_t in = vld4q_u8(src + i * 4);
+            uint8x16x4_t out;
+            for (int k = 0; k < 4; k++) out.val[k] = in.val[order[k]];
+            vst4q_u8(dst + i * 4, out);
+        }
+        shuffle4Scalar(src + i * 4, dst + i * 4, count - i, order);
+    }
+
+    void expand3to4Neon(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+        const uint8x16_t opaque = vdupq_n_u8(255);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            uint8x16x3_t in = vld3q_u8(src + i * 3);
+            uint8x16x4_t out;
+            for (int k = 0; k < 4; k++) out.val[k] = order[k] < 0 ? opaque : in.val[order[k]];
+            vst4q_u8(dst + i * 4, out);
+        }
+        expand3to4Scalar(src + i * 3, dst + i * 4, count - i, order);
+    }
+
+    void shrink4to3Neon(const uint8_t* src, uint8_t* dst, size_t count, const int order[3]) {
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16) {
+            uint8x16x4_t in = vld4q_u8(src + i * 4);
+            uint8x16x3_t out;
+            for (int k = 0; k < 3; k++) out.val[k] = in.val[order[k]];
+            vst3q_u8(dst + i * 3, out);
+        }
+        shrink4to3Scalar(src + i * 4, dst + i * 3, count - i, order);
+    }
+#endif
+}
+
+namespace ofxGlic {
+namespace kernels {
+
+void shuffle4(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+    switch (getSimdLevel()) {
+#if defined(OFXGLIC_SIMD_X86)
+        case SimdLevel::AVX2: shuffle4Avx2(src, dst, count, order); return;
+        case SimdLevel::SSSE3: shuffle4Ssse3(src, dst, count, order); return;
+        case SimdLevel::SSE2: shuffle4Sse2(src, dst, count, order); return;
+#endif
+#if defined(OFXGLIC_SIMD_NEON)
+        case SimdLevel::NEON: shuffle4Neon(src, dst, count, order); return;
+#endif
+        default: shuffle4Scalar(src, dst, count, order); return;
+    }
+}
+
+void expand3to4(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]) {
+    switch (getSimdLevel()) {
+#if defined(OFXGLIC_SIMD_X86)
+        case SimdLevel::AVX2: expand3to4Avx2(src, dst, count, order); return;
+        case SimdLevel::SSSE3: expand3to4Ssse3(src, dst, count, order); return;
+#endif
+#if defined(OFXGLIC_SIMD_NEON)
+        case SimdLevel::NEON: expand3to4Neon(src, dst, count, order); return;
+#endif
+        default: expand3to4Scalar(src, dst, count, order); return;
+    }
+}
+
+void shrink4to3(const uint8_t* src, uint8_t* dst, size_t count, const int order[3]) {
+    switch (getSimdLevel()) {
+#if defined(OFXGLIC_SIMD_X86)
+        case SimdLevel::AVX2: shrink4to3Avx2(src, dst, count, order); return;
+        case SimdLevel::SSSE3: shrink4to3Ssse3(src, dst, count, order); return;
+#endif
+#if defined(OFXGLIC_SIMD_NEON)
+        case SimdLevel::NEON: shrink4to3Neon(src, dst, count, order); return;
+#endif
+        default: shrink4to3Scalar(src, dst, count, order); return;
+    }
+}
+
+}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Byte shuffle kernels behind ofxGlicPixels
+// Each kernel moves whole pixels; order[k] is the source byte of destination
+// byte k within a pixel. Dispatches on ofxGlic::getSimdLevel().
+
+namespace ofxGlic {
+namespace kernels {
+    // 4 -> 4 bytes per pixel (RGBA/BGRA <-> glic::Color)
+    void shuffle4(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]);
+
+    // 3 -> 4 bytes per pixel (RGB/BGR -> glic::Color); order[k] < 0 writes 255
+    void expand3to4(const uint8_t* src, uint8_t* dst, size_t count, const int order[4]);
+
+    // 4 -> 3 bytes per pixel (glic::Color -> RGB/BGR)
+    void shrink4to3(const uint8_t* src, uint8_t* dst, size_t count, const int order[3]);
+}
+}
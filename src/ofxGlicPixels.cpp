@@ -0,0 +1,289 @@
+#include "ofxGlicPixels.h"
+#include "ofxGlicPixelKernels.h"
+#include "glic/glic.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // Where each channel lives inside a glic::Color, as shifts of a native 32-bit word
+    struct ColorLayout {
+        int r = 0;
+        int g = 8;
+        int b = 16;
+        int a = 24;
+        bool valid = false;
+    };
+
+    ColorLayout detectColorLayout() {
+        ColorLayout layout;
+        if (sizeof(glic::Color) != sizeof(uint32_t)) {
+            return layout;
+        }
+
+        glic::Color c = glic::makeColor(1, 2, 3, 4);
+        uint32_t word;
+        std::memcpy(&word, &c, sizeof(word));
+
+        int found = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            switch ((word >> shift) & 0xFF) {
+                case 1: layout.r = shift; found |= 1; break;
+                case 2: layout.g = shift; found |= 2; break;
+                case 3: layout.b = shift; found |= 4; break;
+                case 4: layout.a = shift; found |= 8; break;
+                default: break;
+            }
+        }
+        layout.valid = (found == 15);
+        return layout;
+    }
+
+    const ColorLayout& colorLayout() {
+        static const ColorLayout layout = detectColorLayout();
+        return layout;
+    }
+
+    bool isLittleEndian() {
+        const uint32_t one = 1;
+        uint8_t first;
+        std::memcpy(&first, &one, 1);
+        return first == 1;
+    }
+
+    // Byte offset of each channel inside an ofPixels pixel (A = -1 when there is no alpha)
+    template<int R, int G, int B, int A, int Stride>
+    struct PixelLayout {
+        static constexpr int r = R;
+        static constexpr int g = G;
+        static constexpr int b = B;
+        static constexpr int a = A;
+        static constexpr int stride = Stride;
+        static constexpr bool gray = (Stride < 3);
+    };
+
+    using GrayLayout = PixelLayout<0, 0, 0, -1, 1>;
+    using GrayAlphaLayout = PixelLayout<0, 0, 0, 1, 2>;
+    using RgbLayout = PixelLayout<0, 1, 2, -1, 3>;
+    using BgrLayout = PixelLayout<2, 1, 0, -1, 3>;
+    using RgbaLayout = PixelLayout<0, 1, 2, 3, 4>;
+    using BgraLayout = PixelLayout<2, 1, 0, 3, 4>;
+
+    // Calls fn(Layout()) for the pixel formats that can be converted directly
+    template<typename F>
+    bool withPixelLayout(ofPixelFormat format, F&& fn) {
+        switch (format) {
+            case OF_PIXELS_GRAY:       fn(GrayLayout()); return true;
+            case OF_PIXELS_GRAY_ALPHA: fn(GrayAlphaLayout()); return true;
+            case OF_PIXELS_RGB:        fn(RgbLayout()); return true;
+            case OF_PIXELS_BGR:        fn(BgrLayout()); return true;
+            case OF_PIXELS_RGBA:       fn(RgbaLayout()); return true;
+            case OF_PIXELS_BGRA:       fn(BgraLayout()); return true;
+            default: return false;
+        }
+    }
+
+    // Color and pixel bytes can be moved with the byte shuffle kernels
+    bool useKernels() {
+        return colorLayout().valid && isLittleEndian();
+    }
+
+    template<typename Layout>
+    void packPixels(const uint8_t* src, glic::Color* dst, size_t count) {
+        const ColorLayout& cl = colorLayout();
+
+        if (!Layout::gray && useKernels()) {
+            // Byte k of a glic::Color comes from this pixel byte
+            int order[4];
+            order[cl.r / 8] = Layout::r;
+            order[cl.g / 8] = Layout::g;
+            order[cl.b / 8] = Layout::b;
+            order[cl.a / 8] = Layout::a;
+            if (Layout::stride == 4) {
+                ofxGlic::kernels::shuffle4(src, reinterpret_cast<uint8_t*>(dst), count, order);
+            } else {
+                ofxGlic::kernels::expand3to4(src, reinterpret_cast<uint8_t*>(dst), count, order);
+            }
+            return;
+        }
+
+        if (!cl.valid) {
+            for (size_t i = 0; i < count; i++, src += Layout::stride) {
+                uint8_t a = Layout::a < 0 ? 255 : src[Layout::a];
+                dst[i] = glic::makeColor(src[Layout::r], src[Layout::g], src[Layout::b], a);
+            }
+            return;
+        }
+
+        const int sr = cl.r, sg = cl.g, sb = cl.b, sa = cl.a;
+        for (size_t i = 0; i < count; i++, src += Layout::stride) {
+            uint32_t a = Layout::a < 0 ? 255u : src[Layout::a];
+            uint32_t word = (uint32_t(src[Layout::r]) << sr) | (uint32_t(src[Layout::g]) << sg) |
+                            (uint32_t(src[Layout::b]) << sb) | (a << sa);
+            std::memcpy(&dst[i], &word, sizeof(word));
+        }
+    }
+
+    template<typename Layout>
+    void unpackPixels(const glic::Color* src, uint8_t* dst, size_t count) {
+        const ColorLayout& cl = colorLayout();
+
+        if (!Layout::gray && useKernels()) {
+            // Pixel byte k comes from this glic::Color byte
+            int order[4];
+            order[Layout::r] = cl.r / 8;
+            order[Layout::g] = cl.g / 8;
+            order[Layout::b] = cl.b / 8;
+            const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+            if (Layout::stride == 4) {
+                order[Layout::a < 0 ? 3 : Layout::a] = cl.a / 8;
+                ofxGlic::kernels::shuffle4(in, dst, count, order);
+            } else {
+                ofxGlic::kernels::shrink4to3(in, dst, count, order);
+            }
+            return;
+        }
+
+        if (!cl.valid) {
+            for (size_t i = 0; i < count; i++, dst += Layout::stride) {
+                glic::Color c = src[i];
+                if (Layout::gray) {
+                    dst[0] = std::max(glic::getR(c), std::max(glic::getG(c), glic::getB(c)));
+                } else {
+                    dst[Layout::r] = glic::getR(c);
+                    dst[Layout::g] = glic::getG(c);
+                    dst[Layout::b] = glic::getB(c);
+                }
+                if (Layout::a >= 0) dst[Layout::a] = glic::getA(c);
+            }
+            return;
+        }
+
+        const int sr = cl.r, sg = cl.g, sb = cl.b, sa = cl.a;
+        for (size_t i = 0; i < count; i++, dst += Layout::stride) {
+            uint32_t word;
+            std::memcpy(&word, &src[i], sizeof(word));
+            uint8_t r = (word >> sr) & 0xFF;
+            uint8_t g = (word >> sg) & 0xFF;
+            uint8_t b = (word >> sb) & 0xFF;
+            if (Layout::gray) {
+                // Grayscale stores the brightness, as ofPixels::setColor does
+                dst[0] = std::max(r, std::max(g, b));
+            } else {
+                dst[Layout::r] = r;
+                dst[Layout::g] = g;
+                dst[Layout::b] = b;
+            }
+            if (Layout::a >= 0) dst[Layout::a] = (word >> sa) & 0xFF;
+        }
+    }
+
+    // True when the format's bytes in memory are exactly a glic::Color
+    bool matchesColorLayout(ofPixelFormat format) {
+        const ColorLayout& cl = colorLayout();
+        if (!cl.valid || !isLittleEndian()) return false;
+
+        bool matches = false;
+        withPixelLayout(format, [&](auto layout) {
+            using Layout = decltype(layout);
+            matches = Layout::stride == 4 &&
+                      cl.r == Layout::r * 8 && cl.g == Layout::g * 8 &&
+                      cl.b == Layout::b * 8 && cl.a == Layout::a * 8;
+        });
+        return matches;
+    }
+}
+
+namespace ofxGlic {
+
+bool isColorLayout(const ofPixels& pixels) {
+    if (!pixels.isAllocated() || !matchesColorLayout(pixels.getPixelFormat())) {
+        return false;
+    }
+    return reinterpret_cast<uintptr_t>(pixels.getData()) % alignof(glic::Color) == 0;
+}
+
+void toGlicColors(const ofPixels& pixels, std::vector<glic::Color>& colors) {
+    int width = pixels.getWidth();
+    int height = pixels.getHeight();
+    size_t count = size_t(width) * size_t(height);
+    colors.resize(count);
+    if (count == 0) return;
+
+    if (matchesColorLayout(pixels.getPixelFormat())) {
+        std::memcpy(colors.data(), pixels.getData(), count * sizeof(glic::Color));
+        return;
+    }
+
+    bool converted = withPixelLayout(pixels.getPixelFormat(), [&](auto layout) {
+        packPixels<decltype(layout)>(pixels.getData(), colors.data(), count);
+    });
+    if (converted) return;
+
+    // Uncommon formats: let ofPixels do the conversion
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            ofColor c = pixels.getColor(x, y);
+            colors[size_t(y) * width + x] = glic::makeColor(c.r, c.g, c.b, c.a);
+        }
+    }
+}
+
+void toOfPixels(const glic::Color* colors, int width, int height, ofPixels& pixels) {
+    if (!pixels.isAllocated() || (int)pixels.getWidth() != width || (int)pixels.getHeight() != height) {
+        pixels.allocate(width, height, OF_PIXELS_RGBA);
+    }
+
+    size_t count = size_t(width) * size_t(height);
+    if (count == 0) return;
+
+    if (matchesColorLayout(pixels.getPixelFormat())) {
+        std::memcpy(pixels.getData(), colors, count * sizeof(glic::Color));
+        return;
+    }
+
+    bool converted = withPixelLayout(pixels.getPixelFormat(), [&](auto layout) {
+        unpackPixels<decltype(layout)>(colors, pixels.getData(), count);
+    });
+    if (converted) return;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            glic::Color c = colors[size_t(y) * width + x];
+            pixels.setColor(x, y, ofColor(glic::getR(c), glic::getG(c), glic::getB(c), glic::getA(c)));
+        }
+    }
+}
+
+bool clipRegion(const ofRectangle& region, int width, int height, int& x0, int& y0, int& x1, int& y1) {
+    float left = std::max(region.getLeft(), 0.0f);
+    float top = std::max(region.getTop(), 0.0f);
+    float right = std::min(region.getRight(), float(width));
+    float bottom = std::min(region.getBottom(), float(height));
+    if (right <= left || bottom <= top) return false;
+
+    x0 = int(std::floor(left));
+    y0 = int(std::floor(top));
+    x1 = int(std::ceil(right));
+    y1 = int(std::ceil(bottom));
+    return true;
+}
+}
+
+void ofxGlicColorView::set(const ofPixels& pixels) {
+    set(pixels, buffer_);
+}
+
+void ofxGlicColorView::set(const ofPixels& pixels, std::vector<glic::Color>& scratch) {
+    width_ = pixels.getWidth();
+    height_ = pixels.getHeight();
+
+    if (ofxGlic::isColorLayout(pixels)) {
+        data_ = reinterpret_cast<const glic::Color*>(pixels.getData());
+        borrowed_ = true;
+    } else {
+        ofxGlic::toGlicColors(pixels, scratch);
+        data_ = scratch.data();
+        borrowed_ = false;
+    }
+}
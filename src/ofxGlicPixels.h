@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGlicConfig.h"
+#include <vector>
+
+// Direct ofPixels <-> glic::Color conversion
+// GRAY, GRAY_ALPHA, RGB, BGR, RGBA and BGRA pixels are read and written
+// straight from ofPixels memory instead of going through getColor/setColor.
+// Other pixel formats fall back to getColor/setColor.
+
+namespace ofxGlic {
+    // True when the pixel memory already has the byte layout of glic::Color
+    // and can be passed to glic without conversion
+    bool isColorLayout(const ofPixels& pixels);
+
+    // Convert ofPixels to a glic::Color array (reuses the vector's storage)
+    void toGlicColors(const ofPixels& pixels, std::vector<glic::Color>& colors);
+
+    // Write a glic::Color array into ofPixels
+    // Keeps the current pixel format when pixels is already allocated at
+    // width x height, otherwise allocates RGBA
+    void toOfPixels(const glic::Color* colors, int width, int height, ofPixels& pixels);
+
+    // Pixel bounds [x0, x1) x [y0, y1) of region inside a width x height
+    // frame, as ofxGlicCodec clips decode regions: partly covered pixels
+    // count as inside. False when nothing of the frame is covered.
+    bool clipRegion(const ofRectangle& region, int width, int height, int& x0, int& y0, int& x1, int& y1);
+}
+
+// Read-only glic::Color view of ofPixels
+// Points straight at the pixel memory when the layouts match, otherwise
+// converts into a buffer that is kept and reused between calls.
+class ofxGlicColorView {
+public:
+    ofxGlicColorView() = default;
+    explicit ofxGlicColorView(const ofPixels& pixels) { set(pixels); }
+
+    void set(const ofPixels& pixels);
+
+    // Same, converting into scratch instead of the own buffer when needed
+    // scratch must outlive the use of data()
+    void set(const ofPixels& pixels, std::vector<glic::Color>& scratch);
+
+    const glic::Color* data() const { return data_; }
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+    size_t size() const { return size_t(width_) * size_t(height_); }
+
+    // True when data() points into the ofPixels rather than the own buffer
+    bool isBorrowed() const { return borrowed_; }
+
+private:
+    const glic::Color* data_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+    bool borrowed_ = false;
+    std::vector<glic::Color> buffer_;
+};
@@ -5,7 +5,7 @@ ofxGlicPresets& ofxGlicPresets::instance() {
     return instance;
 }
 
-ofxGlicPresets::ofxGlicPresets() {
+ofxGlicPresets::ofxGlicPresets() : defaultSnapshot_(ofxGlic::makeConfigSnapshot(defaultPreset_.codecConfig)) {
     initBuiltInPresets();
 }
 
@@ -42,8 +42,17 @@ bool ofxGlicPresets::hasPreset(const std::string& name) const {
     return presets_.find(name) != presets_.end();
 }
 
+ofxGlicConfigSnapshot ofxGlicPresets::getConfigSnapshot(const std::string& name) const {
+    auto it = snapshots_.find(name);
+    if (it != snapshots_.end()) {
+        return it->second;
+    }
+    return defaultSnapshot_;
+}
+
 void ofxGlicPresets::addPreset(const ofxGlicPreset& preset) {
     presets_[preset.name] = preset;
+    snapshots_[preset.name] = ofxGlic::makeConfigSnapshot(preset.codecConfig);
 }
 
 // Built-in presets
@@ -31,6 +31,9 @@ public:
     const ofxGlicPreset& getPreset(const std::string& name) const;
     bool hasPreset(const std::string& name) const;
 
+    // Shared immutable copy of a preset's codec config, made once per preset
+    ofxGlicConfigSnapshot getConfigSnapshot(const std::string& name) const;
+
     // Add custom preset
     void addPreset(const ofxGlicPreset& preset);
 
@@ -51,7 +54,9 @@ private:
     void initBuiltInPresets();
 
     std::map<std::string, ofxGlicPreset> presets_;
+    std::map<std::string, ofxGlicConfigSnapshot> snapshots_;
     ofxGlicPreset defaultPreset_;
+    ofxGlicConfigSnapshot defaultSnapshot_;
 };
 
 // Convenience namespace for quick access
@@ -0,0 +1,402 @@
+#include "ofxGlicSequenceExporter.h"
+#include "ofxGlicCodec.h"
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+    // Frames are saved here first and renamed once complete
+    std::string partialPath(const std::string& path) {
+        std::filesystem::path partial(path);
+        partial.replace_extension(".partial" + partial.extension().string());
+        return partial.string();
+    }
+
+    double millisSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+ofxGlicSequenceExporter::~ofxGlicSequenceExporter() {
+    // Queued frames are still written; cancel() is the explicit abort
+    close();
+    wait();
+}
+
+bool ofxGlicSequenceExporter::start(const ofxGlicExportSettings& settings, const ofxGlicPreset& preset) {
+    return startThreads(settings, {preset}, {settings});
+}
+
+bool ofxGlicSequenceExporter::start(const ofxGlicExportSettings& settings, const std::vector<ofxGlicPreset>& presets) {
+    std::vector<ofxGlicExportSettings> outputs;
+    for (const auto& preset : presets) {
+        outputs.push_back(getPresetSettings(settings, preset));
+    }
+    return startThreads(settings, presets, outputs);
+}
+
+bool ofxGlicSequenceExporter::startThreads(const ofxGlicExportSettings& settings,
+                                           const std::vector<ofxGlicPreset>& presets,
+                                           const std::vector<ofxGlicExportSettings>& outputs) {
+    if (isRunning()) return false;
+    wait();
+
+    std::string error = presets.empty() ? "No presets to export" : "";
+    for (const auto& output : outputs) {
+        std::error_code ignored;
+        std::filesystem::create_directories(output.folder, ignored);
+        if (error.empty() && !std::filesystem::is_directory(output.folder)) {
+            error = "Cannot create " + output.folder;
+        }
+    }
+    if (!error.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.lastError = error;
+        return false;
+    }
+
+    size_t numWorkers = settings.numWorkers;
+    if (numWorkers == 0) {
+        numWorkers = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    }
+    numWorkers = std::max<size_t>(1, numWorkers);
+    // A stream is written in frame order by a single thread
+    size_t numWriters = settings.streamOutput ? 1 : std::max<size_t>(1, settings.numWriters);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        settings_ = settings;
+        settings_.queueSize = std::max<size_t>(1, settings.queueSize);
+        presets_ = presets;
+        outputs_ = outputs;
+        closed_ = false;
+        cancelled_ = false;
+        stats_ = ofxGlicExportStats();
+        processMillis_ = 0;
+        writeMillis_ = 0;
+        startTime_ = Clock::now();
+        activeWorkers_ = numWorkers;
+        activeWriters_ = numWriters;
+        reserved_ = 0;
+
+        // The threads wait for the lock before they look at any state
+        for (size_t i = 0; i < numWorkers; i++) {
+            workers_.emplace_back(&ofxGlicSequenceExporter::workerLoop, this);
+        }
+        for (size_t i = 0; i < numWriters; i++) {
+            writers_.emplace_back(&ofxGlicSequenceExporter::writerLoop, this);
+        }
+    }
+    return true;
+}
+
+bool ofxGlicSequenceExporter::push(const ofPixels& frame, int frameIndex) {
+    return enqueue(frame, frameIndex, true);
+}
+
+bool ofxGlicSequenceExporter::tryPush(const ofPixels& frame, int frameIndex) {
+    return enqueue(frame, frameIndex, false);
+}
+
+bool ofxGlicSequenceExporter::enqueue(const ofPixels& frame, int frameIndex, bool block) {
+    // A slot in input_ is reserved before the copy, so frames being copied
+    // count against the queue size and tryPush() never has to wait
+    std::unique_ptr<Frame> job;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (workers_.empty() || closed_ || cancelled_) return false;
+        if (block) {
+            Clock::time_point waitStart = Clock::now();
+            inputSpace_.wait(lock, [this] {
+                return closed_ || cancelled_ || input_.size() + reserved_ < settings_.queueSize;
+            });
+            stats_.pushWaitMillis += millisSince(waitStart);
+            if (closed_ || cancelled_) return false;
+        } else if (input_.size() + reserved_ >= settings_.queueSize) {
+            return false;
+        }
+        reserved_++;
+        job = takeFree();
+    }
+
+    // Copy outside the lock; a recycled frame keeps its allocation
+    job->index = frameIndex;
+    job->pixels = frame;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reserved_--;
+        if (cancelled_) {
+            freeFrames_.push_back(std::move(job));
+            return false;
+        }
+        if (stats_.pushed == 0) firstFrame_ = frameIndex;
+        input_.push_back(std::move(job));
+        stats_.pushed++;
+    }
+    inputReady_.notify_one();
+    return true;
+}
+
+std::unique_ptr<ofxGlicSequenceExporter::Frame> ofxGlicSequenceExporter::takeFree() {
+    if (freeFrames_.empty()) {
+        return std::make_unique<Frame>();
+    }
+    std::unique_ptr<Frame> frame = std::move(freeFrames_.back());
+    freeFrames_.pop_back();
+    return frame;
+}
+
+void ofxGlicSequenceExporter::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    inputReady_.notify_all();
+    inputSpace_.notify_all();
+}
+
+void ofxGlicSequenceExporter::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        for (auto& frame : input_) freeFrames_.push_back(std::move(frame));
+        for (auto& frame : output_) freeFrames_.push_back(std::move(frame));
+        input_.clear();
+        output_.clear();
+    }
+    inputReady_.notify_all();
+    inputSpace_.notify_all();
+    outputReady_.notify_all();
+    outputSpace_.notify_all();
+}
+
+void ofxGlicSequenceExporter::wait() {
+    std::vector<std::thread> workers, writers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workers.swap(workers_);
+        writers.swap(writers_);
+    }
+    for (auto& worker : workers) worker.join();
+    for (auto& writer : writers) writer.join();
+}
+
+bool ofxGlicSequenceExporter::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return activeWriters_ > 0;
+}
+
+ofxGlicExportStats ofxGlicSequenceExporter::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ofxGlicExportStats stats = stats_;
+    stats.inputQueueDepth = input_.size();
+    stats.outputQueueDepth = output_.size();
+
+    double seconds = millisSince(startTime_) / 1000.0;
+    if (seconds > 0) {
+        stats.pushFps = stats.pushed / seconds;
+        stats.processFps = stats.processed / seconds;
+        stats.writeFps = stats.written / seconds;
+    }
+    if (stats.processed > 0) stats.processMillisPerFrame = processMillis_ / stats.processed;
+    if (stats.written > 0) stats.writeMillisPerFrame = writeMillis_ / stats.written;
+    return stats;
+}
+
+std::string ofxGlicSequenceExporter::getFramePath(int frameIndex, size_t presetIndex) const {
+    return presetIndex < outputs_.size() ? getFramePath(outputs_[presetIndex], frameIndex) : std::string();
+}
+
+std::string ofxGlicSequenceExporter::getStreamPath(const ofxGlicExportSettings& settings) {
+    return ofFilePath::join(settings.folder, "frames." + ofxGlicFrameWriter::getExtension(settings.stream.format));
+}
+
+std::string ofxGlicSequenceExporter::getFramePath(const ofxGlicExportSettings& settings, int frameIndex) {
+    char name[1024];
+    std::snprintf(name, sizeof(name), settings.filePattern.c_str(), frameIndex);
+    return ofFilePath::join(settings.folder, name);
+}
+
+ofxGlicExportSettings ofxGlicSequenceExporter::getPresetSettings(const ofxGlicExportSettings& settings,
+                                                                 const ofxGlicPreset& preset) {
+    ofxGlicExportSettings presetSettings = settings;
+    presetSettings.folder = ofFilePath::join(settings.folder, preset.name);
+    return presetSettings;
+}
+
+int ofxGlicSequenceExporter::findResumeFrame(const ofxGlicExportSettings& settings, int numFrames) {
+    // Writers may finish out of order, so resume at the first gap
+    for (int i = 0; i < numFrames; i++) {
+        if (!ofFile::doesFileExist(getFramePath(settings, i), false)) return i;
+    }
+    return numFrames;
+}
+
+int ofxGlicSequenceExporter::findResumeFrame(const ofxGlicExportSettings& settings,
+                                             const std::vector<ofxGlicPreset>& presets, int numFrames) {
+    int resume = numFrames;
+    for (const auto& preset : presets) {
+        resume = std::min(resume, findResumeFrame(getPresetSettings(settings, preset), resume));
+    }
+    return resume;
+}
+
+void ofxGlicSequenceExporter::workerLoop() {
+    // Each thread owns its codec; results stay in the frame, so recycled
+    // frames reuse their buffers
+    ofxGlicCodec codec;
+
+    while (true) {
+        std::unique_ptr<Frame> frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            inputReady_.wait(lock, [this] { return cancelled_ || closed_ || !input_.empty(); });
+            if (cancelled_ || input_.empty()) break;
+            frame = std::move(input_.front());
+            input_.pop_front();
+        }
+        inputSpace_.notify_one();
+
+        Clock::time_point start = Clock::now();
+        std::string error;
+        try {
+            if (!codec.glitchMulti(frame->pixels, presets_, frame->results)) {
+                error = codec.getLastError().empty() ? "Glitch failed" : codec.getLastError();
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        double elapsed = millisSince(start);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        processMillis_ += elapsed;
+        frame->failed = !error.empty();
+        if (frame->failed) {
+            stats_.failed++;
+            stats_.lastError = "Frame " + ofToString(frame->index) + ": " + error;
+        } else {
+            stats_.processed++;
+        }
+
+        outputSpace_.wait(lock, [this] { return cancelled_ || output_.size() < settings_.queueSize; });
+        if (cancelled_) {
+            freeFrames_.push_back(std::move(frame));
+            break;
+        }
+        output_.push_back(std::move(frame));
+        lock.unlock();
+        outputReady_.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        activeWorkers_--;
+    }
+    outputReady_.notify_all();
+}
+
+void ofxGlicSequenceExporter::writerLoop() {
+    std::vector<std::unique_ptr<ofxGlicFrameWriter>> streams;
+    // Stream mode: frames that finished ahead of an earlier one
+    std::map<int, std::unique_ptr<Frame>> waiting;
+    int nextFrame = 0;
+    bool started = false;
+    bool cancelled = false;
+
+    while (true) {
+        std::unique_ptr<Frame> frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            outputReady_.wait(lock, [this] { return cancelled_ || !output_.empty() || activeWorkers_ == 0; });
+            cancelled = cancelled_;
+            if (cancelled_ || output_.empty()) break;
+            frame = std::move(output_.front());
+            output_.pop_front();
+            if (!started) nextFrame = firstFrame_;
+            started = true;
+        }
+        outputSpace_.notify_one();
+
+        if (!settings_.streamOutput) {
+            writeFrame(*frame, streams);
+            std::lock_guard<std::mutex> lock(mutex_);
+            freeFrames_.push_back(std::move(frame));
+            continue;
+        }
+
+        waiting[frame->index] = std::move(frame);
+        while (!waiting.empty() && waiting.begin()->first <= nextFrame) {
+            writeFrame(*waiting.begin()->second, streams);
+            std::lock_guard<std::mutex> lock(mutex_);
+            freeFrames_.push_back(std::move(waiting.begin()->second));
+            waiting.erase(waiting.begin());
+            nextFrame++;
+        }
+    }
+
+    // Frames after a gap in the pushed indices still go out, in order
+    for (auto& entry : waiting) {
+        if (!cancelled) writeFrame(*entry.second, streams);
+        std::lock_guard<std::mutex> lock(mutex_);
+        freeFrames_.push_back(std::move(entry.second));
+    }
+
+    std::string failedPath;
+    for (size_t i = 0; i < streams.size(); i++) {
+        if (streams[i] && !streams[i]->close() && failedPath.empty()) {
+            failedPath = getStreamPath(outputs_[i]);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!failedPath.empty()) {
+        stats_.lastError = "Failed to write " + failedPath;
+    }
+    activeWriters_--;
+}
+
+std::string ofxGlicSequenceExporter::writeFrame(Frame& frame, std::vector<std::unique_ptr<ofxGlicFrameWriter>>& streams) {
+    if (frame.failed) return "";
+
+    Clock::time_point start = Clock::now();
+    std::string failedPath;
+    if (settings_.streamOutput) {
+        // Streams open on the first frame, which gives their size
+        // A failing preset does not skip the others, so their streams stay in step
+        streams.resize(frame.results.size());
+        for (size_t i = 0; i < frame.results.size(); i++) {
+            const ofPixels& result = frame.results[i];
+            std::string path = getStreamPath(outputs_[i]);
+            bool ok = true;
+            if (!streams[i]) {
+                streams[i] = std::make_unique<ofxGlicFrameWriter>();
+                ok = streams[i]->open(path, result.getWidth(), result.getHeight(), settings_.stream);
+            }
+            ok = ok && streams[i]->write(result);
+            if (!ok && failedPath.empty()) failedPath = path;
+        }
+    } else {
+        for (size_t i = 0; i < frame.results.size(); i++) {
+            std::string path = getFramePath(outputs_[i], frame.index);
+            std::string partial = partialPath(path);
+            std::error_code error;
+            bool ok = ofSaveImage(frame.results[i], partial);
+            if (ok) {
+                std::filesystem::rename(partial, path, error);
+                ok = !error;
+            }
+            if (!ok && failedPath.empty()) failedPath = path;
+        }
+    }
+    double elapsed = millisSince(start);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    writeMillis_ += elapsed;
+    if (failedPath.empty()) {
+        stats_.written++;
+    } else {
+        stats_.failed++;
+        stats_.lastError = "Failed to write " + failedPath;
+    }
+    return failedPath;
+}
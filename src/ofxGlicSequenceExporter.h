@@ -0,0 +1,153 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGlicFrameWriter.h"
+#include "ofxGlicPresets.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ofxGlicExportSettings {
+    std::string folder;                      // Created if missing
+    std::string filePattern = "frame_%05d.png";  // printf pattern for the frame index
+    size_t numWorkers = 0;                   // Glitch threads (0 = hardware threads - 1, at least 1)
+    size_t numWriters = 1;                   // Encode-and-save threads
+    size_t queueSize = 4;                    // Frames waiting between two stages
+
+    // Write one video stream file per preset (see getStreamPath) instead of
+    // numbered images; much faster than PNG. Frames must be pushed with
+    // consecutive indices, uses a single writer, and always starts a new file.
+    bool streamOutput = false;
+    ofxGlicFrameWriterSettings stream;
+};
+
+// Progress and per-stage throughput since start()
+struct ofxGlicExportStats {
+    uint64_t pushed = 0;     // Frames handed to push()
+    uint64_t processed = 0;  // Frames glitched
+    uint64_t written = 0;    // Frames saved (with every preset)
+    uint64_t failed = 0;
+    size_t inputQueueDepth = 0;   // Frames waiting for a glitch thread
+    size_t outputQueueDepth = 0;  // Frames waiting for a writer
+
+    // Frames per second of each stage over the elapsed time
+    double pushFps = 0;
+    double processFps = 0;
+    double writeFps = 0;
+    // Time the source spent blocked in push() because the pipeline was full
+    double pushWaitMillis = 0;
+    // Average time one thread spends on one frame
+    double processMillisPerFrame = 0;
+    double writeMillisPerFrame = 0;
+
+    std::string lastError;
+};
+
+// Glitches a frame sequence to numbered image files
+// The caller pushes frames (e.g. from ofVideoPlayer on the main thread);
+// with several presets each frame is read once and glitched with all of
+// them through ofxGlicCodec::glitchMulti().
+// glitch threads and writer threads run behind bounded queues, so image
+// compression and disk writes overlap with codec work. Files are written
+// under a temporary name and renamed when complete, so after a crash
+// findResumeFrame() tells where to continue.
+class ofxGlicSequenceExporter {
+public:
+    ofxGlicSequenceExporter() = default;
+    // Finishes the queued frames, as close() and wait() do
+    ~ofxGlicSequenceExporter();
+
+    ofxGlicSequenceExporter(const ofxGlicSequenceExporter&) = delete;
+    ofxGlicSequenceExporter& operator=(const ofxGlicSequenceExporter&) = delete;
+
+    // Start the threads; false if an export is still running or the folder
+    // cannot be created
+    bool start(const ofxGlicExportSettings& settings, const ofxGlicPreset& preset);
+    // Several presets: each one is saved to a subfolder of settings.folder
+    // named after the preset (see getPresetSettings)
+    bool start(const ofxGlicExportSettings& settings, const std::vector<ofxGlicPreset>& presets);
+
+    // Queue a frame; push() blocks while the pipeline is full, tryPush() returns false
+    // Both return false once the export is closed or cancelled.
+    bool push(const ofPixels& frame, int frameIndex);
+    bool tryPush(const ofPixels& frame, int frameIndex);
+
+    // No more frames: the threads finish the queued ones and stop
+    void close();
+    // Drop the queued frames and stop after the current ones
+    void cancel();
+    // Block until the threads have stopped
+    void wait();
+
+    // True from start() until every frame is written after close(), or cancel()
+    bool isRunning() const;
+    ofxGlicExportStats getStats() const;
+
+    // Path of a frame's file for the preset at presetIndex
+    std::string getFramePath(int frameIndex, size_t presetIndex = 0) const;
+    static std::string getFramePath(const ofxGlicExportSettings& settings, int frameIndex);
+
+    // Stream file in settings.folder: frames.y4m or frames.rgba
+    static std::string getStreamPath(const ofxGlicExportSettings& settings);
+
+    // Settings of one preset's subfolder in a multi-preset export
+    static ofxGlicExportSettings getPresetSettings(const ofxGlicExportSettings& settings, const ofxGlicPreset& preset);
+
+    // First frame in [0, numFrames) without a complete file (numFrames when all exist)
+    static int findResumeFrame(const ofxGlicExportSettings& settings, int numFrames);
+    // Same for a multi-preset export: the first frame missing for any preset
+    static int findResumeFrame(const ofxGlicExportSettings& settings, const std::vector<ofxGlicPreset>& presets,
+                               int numFrames);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame {
+        int index = 0;
+        ofPixels pixels;
+        std::vector<ofPixels> results;  // One per preset
+        bool failed = false;            // Glitching failed; passed on so streams can skip it
+    };
+
+    bool startThreads(const ofxGlicExportSettings& settings, const std::vector<ofxGlicPreset>& presets,
+                      const std::vector<ofxGlicExportSettings>& outputs);
+
+    bool enqueue(const ofPixels& frame, int frameIndex, bool block);
+    std::unique_ptr<Frame> takeFree();
+    void workerLoop();
+    void writerLoop();
+    // Save one glitched frame; returns the path that failed, if any
+    std::string writeFrame(Frame& frame, std::vector<std::unique_ptr<ofxGlicFrameWriter>>& streams);
+
+    ofxGlicExportSettings settings_;
+    std::vector<ofxGlicPreset> presets_;
+    std::vector<ofxGlicExportSettings> outputs_;  // Where each preset's frames go
+
+    std::vector<std::thread> workers_;  // Only touched under mutex_; wait() joins them outside it
+    std::vector<std::thread> writers_;
+    std::deque<std::unique_ptr<Frame>> input_;
+    std::deque<std::unique_ptr<Frame>> output_;
+    std::vector<std::unique_ptr<Frame>> freeFrames_;  // Recycled so frames keep their allocation
+    size_t activeWorkers_ = 0;
+    size_t activeWriters_ = 0;
+    size_t reserved_ = 0;  // Slots in input_ held by frames still being copied in
+    int firstFrame_ = 0;  // Index of the first frame pushed
+    bool closed_ = false;
+    bool cancelled_ = false;
+
+    ofxGlicExportStats stats_;
+    Clock::time_point startTime_;
+    double processMillis_ = 0;
+    double writeMillis_ = 0;
+
+    mutable std::mutex mutex_;
+    std::condition_variable inputReady_;   // input_ has a frame, or closed
+    std::condition_variable inputSpace_;   // input_ has room
+    std::condition_variable outputReady_;  // output_ has a frame, or the workers are done
+    std::condition_variable outputSpace_;  // output_ has room
+};
@@ -0,0 +1,94 @@
+#include "ofxGlicSession.h"
+#include <iterator>
+
+void ofxGlicSession::setSource(const ofPixels& source) {
+    ofxGlic::toGlicColors(source, source_);
+    width_ = source.getWidth();
+    height_ = source.getHeight();
+    numConversions_++;
+
+    // Cached results belong to the old source
+    clearCache();
+}
+
+void ofxGlicSession::setConfig(const glic::CodecConfig& config) {
+    if (decodedValid_ && ofxGlic::configEquals(config, config_)) return;
+    config_ = config;
+    decodedValid_ = false;
+    outputValid_ = false;
+}
+
+void ofxGlicSession::setEffects(const std::vector<ofxGlicEffect>& effects) {
+    if (effects == effects_) return;
+    effects_ = effects;
+    outputValid_ = false;
+}
+
+void ofxGlicSession::setTiling(bool enabled, int tileSize) {
+    codec_.setTiling(enabled, tileSize);
+    clearCache();
+}
+
+void ofxGlicSession::setCacheSize(size_t size) {
+    cacheSize_ = std::max<size_t>(1, size);
+    while (cache_.size() > cacheSize_) {
+        cache_.pop_back();
+    }
+}
+
+void ofxGlicSession::clearCache() {
+    cache_.clear();
+    decodedValid_ = false;
+    outputValid_ = false;
+}
+
+bool ofxGlicSession::update() {
+    if (source_.empty()) {
+        lastError_ = "No source set";
+        return false;
+    }
+
+    if (!decodedValid_) {
+        uint64_t hash = ofxGlic::configHash(config_);
+        auto it = cache_.begin();
+        for (; it != cache_.end(); ++it) {
+            if (it->hash == hash && ofxGlic::configEquals(it->config, config_)) break;
+        }
+
+        if (it != cache_.end()) {
+            cache_.splice(cache_.begin(), cache_, it);
+            numCacheHits_++;
+        } else {
+            // Reuse the least recently used entry's pixel allocation when full
+            if (cache_.size() >= cacheSize_) {
+                cache_.splice(cache_.begin(), cache_, std::prev(cache_.end()));
+            } else {
+                cache_.emplace_front();
+            }
+            CacheEntry& entry = cache_.front();
+            entry.config = config_;
+            entry.hash = hash;
+
+            codec_.setConfig(config_);
+            numEncodes_++;
+            if (!codec_.glitch(source_.data(), width_, height_, entry.pixels)) {
+                lastError_ = codec_.getLastError();
+                cache_.pop_front();
+                return false;
+            }
+        }
+        decodedValid_ = true;
+        outputValid_ = false;
+    }
+
+    if (!outputValid_ && !effects_.empty()) {
+        output_ = cache_.front().pixels;
+        effectsProcessor_.setEffects(effects_);
+        effectsProcessor_.apply(output_);
+        numEffectPasses_++;
+    }
+    outputValid_ = true;
+
+    lastError_.clear();
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGlicCodec.h"
+#include "ofxGlicConfig.h"
+#include "ofxGlicEffects.h"
+#include <list>
+#include <vector>
+
+// Interactive glitch pipeline that only reruns what changed
+// The pipeline is source -> glic::Color conversion -> encode + decode -> effects.
+// update() reruns a stage only when one of its inputs changed:
+//  - the source is converted once per setSource()
+//  - decoded results are cached per config, so going back to an earlier
+//    slider value costs no encode
+//  - changing only the effects reapplies them to the cached decode
+// A codec parameter change reruns the whole encode: glic::GlicCodec::encode
+// goes from RGB colors to a bitstream in one call, and its stages (color
+// space, segmentation, prediction, quantization) take no outside input.
+class ofxGlicSession {
+public:
+    ofxGlicSession() = default;
+
+    ofxGlicSession(const ofxGlicSession&) = delete;
+    ofxGlicSession& operator=(const ofxGlicSession&) = delete;
+
+    // Pipeline inputs; setting an unchanged value keeps the cached stages
+    void setSource(const ofPixels& source);
+    void setConfig(const glic::CodecConfig& config);
+    void setEffects(const std::vector<ofxGlicEffect>& effects);
+    const glic::CodecConfig& getConfig() const { return config_; }
+    const std::vector<ofxGlicEffect>& getEffects() const { return effects_; }
+
+    // Tiled mode (changes the output, so it clears the cache)
+    void setTiling(bool enabled, int tileSize = 512);
+    void setNumThreads(size_t numThreads) { codec_.setNumThreads(numThreads); }
+
+    // Number of decoded results kept (default 8)
+    void setCacheSize(size_t size);
+    size_t getCacheSize() const { return cacheSize_; }
+    void clearCache();
+
+    // Bring the output up to date; false when encoding or decoding failed
+    bool update();
+
+    // Output of the last successful update()
+    const ofPixels& getPixels() const { return effects_.empty() ? getDecodedPixels() : output_; }
+    // Decoded result before effects
+    const ofPixels& getDecodedPixels() const { return cache_.empty() ? output_ : cache_.front().pixels; }
+    const std::string& getLastError() const { return lastError_; }
+
+    // Stage counters since construction
+    uint64_t getNumConversions() const { return numConversions_; }
+    uint64_t getNumEncodes() const { return numEncodes_; }
+    uint64_t getNumCacheHits() const { return numCacheHits_; }
+    uint64_t getNumEffectPasses() const { return numEffectPasses_; }
+
+private:
+    // Decoded result of one config
+    struct CacheEntry {
+        glic::CodecConfig config;
+        uint64_t hash = 0;
+        ofPixels pixels;
+    };
+
+    ofxGlicCodec codec_;
+    ofxGlicEffects effectsProcessor_;
+    glic::CodecConfig config_;
+    std::vector<ofxGlicEffect> effects_;
+
+    std::vector<glic::Color> source_;
+    int width_ = 0;
+    int height_ = 0;
+
+    std::list<CacheEntry> cache_;  // Most recently used first
+    size_t cacheSize_ = 8;
+
+    ofPixels output_;
+    bool decodedValid_ = false;  // The front cache entry is the result of config_
+    bool outputValid_ = false;   // output_ is that result with effects_ applied
+    std::string lastError_;
+
+    uint64_t numConversions_ = 0;
+    uint64_t numEncodes_ = 0;
+    uint64_t numCacheHits_ = 0;
+    uint64_t numEffectPasses_ = 0;
+};
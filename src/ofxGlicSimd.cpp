@@ -0,0 +1,100 @@
+#include "ofxGlicSimd.h"
+#include <atomic>
+
+#if defined(OFXGLIC_SIMD_X86) && defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace {
+#if defined(OFXGLIC_SIMD_X86)
+    #if defined(_MSC_VER)
+    bool cpuHasSsse3() {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 9)) != 0;
+    }
+
+    bool cpuHasAvx2() {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        // AVX also needs the OS to save the YMM registers
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }
+
+    bool cpuHasSse2() {
+    #if defined(_M_X64)
+        return true;
+    #else
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+    #endif
+    }
+    #else
+    bool cpuHasSse2() { return __builtin_cpu_supports("sse2"); }
+    bool cpuHasSsse3() { return __builtin_cpu_supports("ssse3"); }
+    bool cpuHasAvx2() { return __builtin_cpu_supports("avx2"); }
+    #endif
+#endif
+
+    ofxGlic::SimdLevel detectSimdLevel() {
+#if defined(OFXGLIC_SIMD_X86)
+        if (cpuHasAvx2()) return ofxGlic::SimdLevel::AVX2;
+        if (cpuHasSsse3()) return ofxGlic::SimdLevel::SSSE3;
+        if (cpuHasSse2()) return ofxGlic::SimdLevel::SSE2;
+#elif defined(OFXGLIC_SIMD_NEON)
+        return ofxGlic::SimdLevel::NEON;
+#endif
+        return ofxGlic::SimdLevel::SCALAR;
+    }
+
+    std::atomic<ofxGlic::SimdLevel>& activeLevel() {
+        static std::atomic<ofxGlic::SimdLevel> level(ofxGlic::getSupportedSimdLevel());
+        return level;
+    }
+}
+
+namespace ofxGlic {
+
+SimdLevel getSupportedSimdLevel() {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+SimdLevel getSimdLevel() {
+    return activeLevel().load(std::memory_order_relaxed);
+}
+
+bool setSimdLevel(SimdLevel level) {
+    if (!isSimdLevelSupported(level)) return false;
+    activeLevel().store(level, std::memory_order_relaxed);
+    return true;
+}
+
+bool isSimdLevelSupported(SimdLevel level) {
+    SimdLevel supported = getSupportedSimdLevel();
+    if (level == SimdLevel::SCALAR || level == supported) return true;
+    if (level == SimdLevel::NEON || supported == SimdLevel::NEON) return false;
+    return static_cast<int>(level) <= static_cast<int>(supported);
+}
+
+std::string getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return "Scalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::SSSE3: return "SSSE3";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::NEON: return "NEON";
+    }
+    return "Unknown";
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+// CPU feature detection and kernel dispatch level for ofxGlic
+// Kernels are compiled per instruction set with function target attributes,
+// so the addon needs no extra compiler flags; the best level the CPU supports
+// is picked at runtime.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define OFXGLIC_SIMD_X86 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define OFXGLIC_SIMD_NEON 1
+#endif
+
+#if defined(OFXGLIC_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define OFXGLIC_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define OFXGLIC_TARGET(isa)
+#endif
+
+namespace ofxGlic {
+    enum class SimdLevel {
+        SCALAR,
+        SSE2,
+        SSSE3,
+        AVX2,
+        NEON
+    };
+
+    // Best level supported by this CPU
+    SimdLevel getSupportedSimdLevel();
+
+    // Level the kernels currently dispatch to (defaults to the supported level)
+    SimdLevel getSimdLevel();
+
+    // Restrict dispatch to a lower level, e.g. to compare against SCALAR
+    // Returns false and leaves the level unchanged if the CPU lacks it
+    bool setSimdLevel(SimdLevel level);
+
+    bool isSimdLevelSupported(SimdLevel level);
+    std::string getSimdLevelName(SimdLevel level);
+}
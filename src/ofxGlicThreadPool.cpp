@@ -0,0 +1,170 @@
+#include "ofxGlicThreadPool.h"
+#include <algorithm>
+
+namespace {
+    // Shared between the caller of parallelFor and its helper tasks;
+    // helpers may start after the caller has returned, so it is ref-counted
+    struct ParallelForState {
+        const std::function<void(size_t)>* fn = nullptr;
+        size_t count = 0;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> remaining{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+
+        // Claim and run indices until none are left
+        void run() {
+            size_t i;
+            while ((i = next.fetch_add(1)) < count) {
+                try {
+                    (*fn)(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) error = std::current_exception();
+                }
+                if (remaining.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.notify_all();
+                }
+            }
+        }
+    };
+
+    // Pool and worker index of the calling thread, if it is a pool thread
+    thread_local const ofxGlicThreadPool* currentPool = nullptr;
+    thread_local size_t currentWorker = 0;
+}
+
+ofxGlicThreadPool::ofxGlicThreadPool(size_t numThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    queues_.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    workers_.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        workers_.emplace_back(&ofxGlicThreadPool::workerLoop, this, i);
+    }
+}
+
+ofxGlicThreadPool::~ofxGlicThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+ofxGlicThreadPool& ofxGlicThreadPool::shared() {
+    static ofxGlicThreadPool pool;
+    return pool;
+}
+
+void ofxGlicThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& fn, size_t maxThreads) {
+    if (count == 0) return;
+
+    size_t threads = std::min(count, workers_.size() + 1);
+    if (maxThreads > 0) threads = std::min(threads, maxThreads);
+
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++) fn(i);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>();
+    state->fn = &fn;
+    state->count = count;
+    state->remaining = count;
+
+    for (size_t i = 1; i < threads; i++) {
+        enqueue([state]() { state->run(); });
+    }
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&] { return state->remaining.load() == 0; });
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+void ofxGlicThreadPool::enqueue(Task task) {
+    if (currentPool == this) {
+        WorkerQueue& queue = *queues_[currentWorker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    } else {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+
+    {
+        // Counted under the lock the workers sleep on, so no wake-up is missed
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_++;
+    }
+    condition_.notify_one();
+}
+
+bool ofxGlicThreadPool::takeTask(size_t worker, Task& task) {
+    // Own deque first, newest task: its data is most likely still in cache
+    {
+        WorkerQueue& queue = *queues_[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!tasks_.empty()) {
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another worker
+    for (size_t i = 1; i < queues_.size(); i++) {
+        WorkerQueue& queue = *queues_[(worker + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            steals_++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ofxGlicThreadPool::workerLoop(size_t worker) {
+    currentPool = this;
+    currentWorker = worker;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this] { return stopping_ || pending_.load() > 0; });
+            if (stopping_ && pending_.load() == 0) return;
+        }
+
+        Task task;
+        if (takeTask(worker, task)) {
+            pending_--;
+            task();
+        } else {
+            // Another worker got there between the count and the take
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size work-stealing pool used by the tiled codec and other parallel paths
+// Tasks queued from a pool thread go to that thread's own deque and are run
+// newest first; idle threads take from the shared queue, then steal the
+// oldest tasks of the others.
+class ofxGlicThreadPool {
+public:
+    // 0 threads = one per hardware thread
+    explicit ofxGlicThreadPool(size_t numThreads = 0);
+    ~ofxGlicThreadPool();
+
+    ofxGlicThreadPool(const ofxGlicThreadPool&) = delete;
+    ofxGlicThreadPool& operator=(const ofxGlicThreadPool&) = delete;
+
+    // Process-wide pool shared by ofxGlic
+    static ofxGlicThreadPool& shared();
+
+    size_t getNumThreads() const { return workers_.size(); }
+
+    // Tasks taken from another thread's deque since construction
+    uint64_t getNumSteals() const { return steals_.load(); }
+
+    // Queue a task; the future carries its result or exception
+    template<typename F>
+    auto submit(F&& fn) -> std::future<decltype(fn())> {
+        using Result = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(fn));
+        std::future<Result> future = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    // Run fn(i) for every i in [0, count) and wait for all of them
+    // Uses at most maxThreads threads including the caller (0 = no limit).
+    // The calling thread takes part, so nested calls from pool tasks cannot deadlock.
+    // The first exception thrown by fn is rethrown here.
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn, size_t maxThreads = 0);
+
+private:
+    using Task = std::function<void()>;
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void enqueue(Task task);
+    bool takeTask(size_t worker, Task& task);
+    void workerLoop(size_t worker);
+
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;  // One per worker
+    std::deque<Task> tasks_;  // Tasks queued from outside the pool
+    std::atomic<size_t> pending_{0};  // Tasks in any queue
+    std::atomic<uint64_t> steals_{0};
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stopping_ = false;
+};
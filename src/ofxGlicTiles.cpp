@@ -0,0 +1,131 @@
+#include "ofxGlicTiles.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const char kMagic[8] = {'G', 'L', 'I', 'C', 'T', 'I', 'L', 'E'};
+    const uint32_t kVersion = 1;
+    const size_t kFixedHeaderSize = sizeof(kMagic) + 6 * sizeof(uint32_t);
+
+    // Largest accepted frame side, guards against corrupt headers
+    const uint32_t kMaxDimension = 1 << 16;
+
+    void putU32(std::vector<uint8_t>& out, uint32_t v) {
+        for (int i = 0; i < 4; i++) out.push_back(uint8_t(v >> (8 * i)));
+    }
+
+    void putU64(std::vector<uint8_t>& out, uint64_t v) {
+        for (int i = 0; i < 8; i++) out.push_back(uint8_t(v >> (8 * i)));
+    }
+
+    uint32_t getU32(const uint8_t* p) {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    uint64_t getU64(const uint8_t* p) {
+        return uint64_t(getU32(p)) | (uint64_t(getU32(p + 4)) << 32);
+    }
+}
+
+int ofxGlicTileLayout::getNumTilesX() const {
+    return tileWidth > 0 ? (width + tileWidth - 1) / tileWidth : 0;
+}
+
+int ofxGlicTileLayout::getNumTilesY() const {
+    return tileHeight > 0 ? (height + tileHeight - 1) / tileHeight : 0;
+}
+
+int ofxGlicTileLayout::getNumTiles() const {
+    return getNumTilesX() * getNumTilesY();
+}
+
+void ofxGlicTileLayout::getTileBounds(int index, int& x, int& y, int& w, int& h) const {
+    int tilesX = getNumTilesX();
+    x = (index % tilesX) * tileWidth;
+    y = (index / tilesX) * tileHeight;
+    w = std::min(tileWidth, width - x);
+    h = std::min(tileHeight, height - y);
+}
+
+namespace ofxGlic {
+
+bool isTiledStream(const uint8_t* data, size_t size) {
+    return data != nullptr && size >= sizeof(kMagic) && std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+void writeTiledStream(const ofxGlicTileLayout& layout, const std::vector<std::vector<uint8_t>>& tiles,
+                      std::vector<uint8_t>& out) {
+    size_t numTiles = layout.getNumTiles();
+    size_t total = kFixedHeaderSize + numTiles * sizeof(uint64_t);
+    for (size_t i = 0; i < numTiles; i++) total += tiles[i].size();
+
+    out.clear();
+    out.reserve(total);
+    out.insert(out.end(), kMagic, kMagic + sizeof(kMagic));
+    putU32(out, kVersion);
+    putU32(out, layout.width);
+    putU32(out, layout.height);
+    putU32(out, layout.tileWidth);
+    putU32(out, layout.tileHeight);
+    putU32(out, uint32_t(numTiles));
+    for (size_t i = 0; i < numTiles; i++) putU64(out, tiles[i].size());
+    for (size_t i = 0; i < numTiles; i++) out.insert(out.end(), tiles[i].begin(), tiles[i].end());
+}
+
+bool readTiledStream(const uint8_t* data, size_t size, ofxGlicTileLayout& layout,
+                     std::vector<ofxGlicTileRange>& tiles, std::string& error) {
+    if (!isTiledStream(data, size) || size < kFixedHeaderSize) {
+        error = "Not a tiled glic stream";
+        return false;
+    }
+
+    const uint8_t* p = data + sizeof(kMagic);
+    uint32_t version = getU32(p);
+    if (version != kVersion) {
+        error = "Unsupported tiled stream version " + std::to_string(version);
+        return false;
+    }
+
+    uint32_t width = getU32(p + 4);
+    uint32_t height = getU32(p + 8);
+    uint32_t tileWidth = getU32(p + 12);
+    uint32_t tileHeight = getU32(p + 16);
+    uint32_t numTiles = getU32(p + 20);
+    if (width == 0 || height == 0 || tileWidth == 0 || tileHeight == 0 ||
+        width > kMaxDimension || height > kMaxDimension) {
+        error = "Invalid tile layout";
+        return false;
+    }
+
+    layout.width = width;
+    layout.height = height;
+    layout.tileWidth = std::min(tileWidth, width);
+    layout.tileHeight = std::min(tileHeight, height);
+    if (numTiles != uint32_t(layout.getNumTiles())) {
+        error = "Tile count does not match the tile layout";
+        return false;
+    }
+
+    size_t offset = kFixedHeaderSize + size_t(numTiles) * sizeof(uint64_t);
+    if (offset > size) {
+        error = "Truncated tiled stream";
+        return false;
+    }
+
+    tiles.resize(numTiles);
+    const uint8_t* sizes = data + kFixedHeaderSize;
+    for (uint32_t i = 0; i < numTiles; i++) {
+        uint64_t tileSize = getU64(sizes + i * sizeof(uint64_t));
+        if (tileSize > size - offset) {
+            error = "Truncated tiled stream";
+            return false;
+        }
+        tiles[i].offset = offset;
+        tiles[i].size = size_t(tileSize);
+        offset += size_t(tileSize);
+    }
+
+    return true;
+}
+
+}
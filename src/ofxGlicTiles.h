@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Tile grid of a frame
+// Tiles are numbered row-major; tiles on the right and bottom edges are clipped.
+struct ofxGlicTileLayout {
+    int width = 0;
+    int height = 0;
+    int tileWidth = 0;
+    int tileHeight = 0;
+
+    int getNumTilesX() const;
+    int getNumTilesY() const;
+    int getNumTiles() const;
+
+    // Pixel bounds of a tile
+    void getTileBounds(int index, int& x, int& y, int& w, int& h) const;
+};
+
+// Where one tile's glic bitstream sits inside a tiled stream
+struct ofxGlicTileRange {
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+// Tiled stream format (all integers little-endian):
+//   8 bytes    "GLICTILE"
+//   uint32     format version
+//   uint32 x4  width, height, tileWidth, tileHeight
+//   uint32     tile count
+//   uint64 xN  size of each tile's bitstream
+//   ...        tile bitstreams in tile order, each a plain glic stream
+
+namespace ofxGlic {
+    // True when the data starts with the tiled stream magic
+    bool isTiledStream(const uint8_t* data, size_t size);
+
+    // Write the header and tile bitstreams into out (reuses its storage)
+    void writeTiledStream(const ofxGlicTileLayout& layout, const std::vector<std::vector<uint8_t>>& tiles,
+                          std::vector<uint8_t>& out);
+
+    // Parse the header and locate each tile's bitstream without copying it
+    bool readTiledStream(const uint8_t* data, size_t size, ofxGlicTileLayout& layout,
+                         std::vector<ofxGlicTileRange>& tiles, std::string& error);
+}
@@ -0,0 +1,46 @@
+#include "ofxGlicWorkspace.h"
+
+ofxGlicWorkspace::Scope::Scope(ofxGlicWorkspace& workspace)
+    : workspace_(workspace), colorsMark_(workspace.colorsUsed_), bytesMark_(workspace.bytesUsed_) {
+}
+
+ofxGlicWorkspace::Scope::~Scope() {
+    workspace_.colorsUsed_ = colorsMark_;
+    workspace_.bytesUsed_ = bytesMark_;
+}
+
+std::vector<glic::Color>& ofxGlicWorkspace::acquireColors(size_t count) {
+    if (colorsUsed_ == colors_.size()) {
+        colors_.emplace_back();
+    }
+    std::vector<glic::Color>& buffer = colors_[colorsUsed_++];
+    buffer.resize(count);
+    return buffer;
+}
+
+std::vector<uint8_t>& ofxGlicWorkspace::acquireBytes(size_t count) {
+    if (bytesUsed_ == bytes_.size()) {
+        bytes_.emplace_back();
+    }
+    std::vector<uint8_t>& buffer = bytes_[bytesUsed_++];
+    buffer.resize(count);
+    return buffer;
+}
+
+void ofxGlicWorkspace::reset() {
+    colorsUsed_ = 0;
+    bytesUsed_ = 0;
+}
+
+void ofxGlicWorkspace::release() {
+    colors_.clear();
+    bytes_.clear();
+    reset();
+}
+
+size_t ofxGlicWorkspace::getCapacityBytes() const {
+    size_t total = 0;
+    for (const auto& buffer : colors_) total += buffer.capacity() * sizeof(glic::Color);
+    for (const auto& buffer : bytes_) total += buffer.capacity();
+    return total;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ofxGlicConfig.h"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Scratch buffers for one processing thread
+// Buffers are handed out in order and only ever grow. Everything acquired
+// inside a Scope is handed back when the scope ends, so a frame that has the
+// same shape as the previous one reuses the same memory and does not allocate.
+// ofxGlicCodec and ofxGlicEffects open their own scopes; several of them can
+// share one workspace as long as they run on the same thread.
+class ofxGlicWorkspace {
+public:
+    class Scope {
+    public:
+        explicit Scope(ofxGlicWorkspace& workspace);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ofxGlicWorkspace& workspace_;
+        size_t colorsMark_;
+        size_t bytesMark_;
+    };
+
+    // Next free buffer, resized to count (capacity is kept across frames)
+    std::vector<glic::Color>& acquireColors(size_t count);
+    std::vector<uint8_t>& acquireBytes(size_t count = 0);
+
+    // Hand back every buffer (only call between frames)
+    void reset();
+
+    // Free all memory
+    void release();
+
+    // Memory held by the workspace
+    size_t getCapacityBytes() const;
+
+private:
+    std::deque<std::vector<glic::Color>> colors_;
+    std::deque<std::vector<uint8_t>> bytes_;
+    size_t colorsUsed_ = 0;
+    size_t bytesUsed_ = 0;
+};
@@ -0,0 +1,8 @@
+#include "testing.h"
+
+// Runs every test, or those whose name contains the first argument, and
+// exits with 1 when any test fails
+int main(int argc, char* argv[]) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    return ofxGlicTest::runTests(filter) == 0 ? 0 : 1;
+}
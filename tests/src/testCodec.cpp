@@ -0,0 +1,277 @@
+#include "testing.h"
+#include <fstream>
+
+using namespace ofxGlicTest;
+
+OFXGLIC_TEST(glitchMatchesBufferRoundTrip) {
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+
+    for (auto format : {OF_PIXELS_RGB, OF_PIXELS_RGBA}) {
+        ofPixels source = makeTestPixels(320, 240, format);
+        ofImage sourceImage;
+        sourceImage.setFromPixels(source);
+        ofxGlicResult result = codec.decodeFromBuffer(codec.encodeToBuffer(sourceImage));
+
+        ofPixels out;
+        CHECK(codec.glitch(source, out));
+        CHECK_MESSAGE(result.success && samePixels(out, result.image.getPixels()), formatName(format));
+    }
+}
+
+// The bitstream and the decoded pixels must not depend on the thread count
+OFXGLIC_TEST(tiledCodecIsDeterministic) {
+    ofPixels source = makeTestPixels(1100, 700, OF_PIXELS_RGBA);
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+    codec.setTiling(true, 256);
+
+    std::vector<uint8_t> reference, buffer;
+    ofPixels referenceOut, out;
+    size_t maxThreads = ofxGlicThreadPool::shared().getNumThreads() + 1;
+    for (size_t threads : {size_t(1), size_t(2), size_t(3), maxThreads}) {
+        codec.setNumThreads(threads);
+        CHECK(codec.encodeFrom(source, buffer));
+        CHECK(codec.decodeInto(buffer, out));
+        if (reference.empty()) {
+            reference = buffer;
+            referenceOut = out;
+        } else {
+            CHECK_MESSAGE(buffer == reference && samePixels(out, referenceOut), ofToString(threads) + " threads");
+        }
+    }
+}
+
+// Per-channel mode gives the same pixels for any thread count, and the same
+// pixels as one glic codec running all three channels
+OFXGLIC_TEST(channelParallelMatchesSingleCodec) {
+    ofPixels source = makeTestPixels(400, 300, OF_PIXELS_RGB);
+    for (const auto& name : ofxGlicPresets::instance().getPresetNames()) {
+        ofxGlicCodec codec;
+        codec.setConfig(ofxGlicPresets::instance().getPreset(name).codecConfig);
+        ofPixels expected;
+        CHECK(codec.glitch(source, expected));
+
+        codec.setChannelParallel(true);
+        for (size_t threads : {1, 2, 3, 0}) {
+            codec.setNumThreads(threads);
+            ofPixels out;
+            CHECK(codec.glitch(source, out));
+            CHECK_MESSAGE(samePixels(out, expected), name + ", " + ofToString(threads) + " threads");
+        }
+    }
+}
+
+OFXGLIC_TEST(colorLutMatchesGlicConversion) {
+    for (auto direction : {ofxGlicColorLut::TO_SPACE, ofxGlicColorLut::FROM_SPACE}) {
+        ofxGlicColorLut lut(glic::ColorSpace::LAB, direction);
+        size_t mismatches = 0;
+        for (uint32_t rgb = 0; rgb < (1u << 24); rgb++) {
+            glic::Color color = glic::makeColor(uint8_t(rgb >> 16), uint8_t(rgb >> 8), uint8_t(rgb), uint8_t(rgb * 7));
+            glic::Color expected = direction == ofxGlicColorLut::TO_SPACE
+                                       ? glic::toColorspace(color, glic::ColorSpace::LAB)
+                                       : glic::fromColorspace(color, glic::ColorSpace::LAB);
+            if (lut.convert(color) != expected) mismatches++;
+        }
+        CHECK_MESSAGE(mismatches == 0, ofToString(mismatches) + " mismatches");
+    }
+}
+
+OFXGLIC_TEST(colorLutGlitchMatchesGlicConversion) {
+    ofPixels source = makeTestPixels(400, 300, OF_PIXELS_RGBA);
+    for (const auto& name : ofxGlicPresets::instance().getPresetNames()) {
+        ofxGlicCodec codec;
+        codec.setConfig(ofxGlicPresets::instance().getPreset(name).codecConfig);
+        codec.setChannelParallel(true);
+        ofPixels expected, out;
+        CHECK(codec.glitch(source, expected));
+        codec.setColorLut(true);
+        CHECK(codec.glitch(source, out));
+        CHECK_MESSAGE(samePixels(out, expected), name);
+    }
+    ofxGlicColorLut::releaseShared();
+}
+
+OFXGLIC_TEST(fileDecodeMatchesBufferDecode) {
+    TempFolder folder("ofxGlicTestDecode");
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+    codec.setTiling(true, 256);
+
+    std::vector<uint8_t> stream;
+    codec.encodeFrom(makeTestPixels(900, 600, OF_PIXELS_RGBA), stream);
+    std::string path = folder.path("tiled.glic");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(stream.data()), stream.size());
+    }
+
+    ofxGlicResult viaVector = codec.decodeFromBuffer(stream);
+    ofxGlicResult viaMap = codec.decode(path);
+    std::ifstream file(path, std::ios::binary);
+    ofxGlicResult viaStream = codec.decodeFromStream(file);
+
+    CHECK(viaVector.success && viaMap.success && viaStream.success);
+    CHECK(samePixels(viaVector.image.getPixels(), viaMap.image.getPixels()));
+    CHECK(samePixels(viaVector.image.getPixels(), viaStream.image.getPixels()));
+}
+
+OFXGLIC_TEST(regionDecodeMatchesCrop) {
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+    codec.setTiling(true, 256);
+
+    std::vector<uint8_t> stream;
+    codec.encodeFrom(makeTestPixels(1500, 1000, OF_PIXELS_RGBA), stream);
+
+    ofPixels full;
+    CHECK(codec.decodeInto(stream, full));
+    // Deliberately not aligned to the tile grid, and one cut by the frame edge
+    for (const ofRectangle& window : {ofRectangle(300, 170, 640, 360), ofRectangle(1200, 900, 500, 300)}) {
+        ofPixels region;
+        CHECK(codec.decodeRegionInto(stream.data(), stream.size(), window, region));
+        ofPixels crop;
+        float width = std::min(window.width, 1500 - window.x);
+        float height = std::min(window.height, 1000 - window.y);
+        full.cropTo(crop, window.x, window.y, width, height);
+        CHECK_MESSAGE(samePixels(crop, region), ofToString(window.x) + ", " + ofToString(window.y));
+    }
+}
+
+// Equal configs hash alike, and presets that differ do not collide
+OFXGLIC_TEST(configHashMatchesEquality) {
+    auto& presets = ofxGlicPresets::instance();
+    std::vector<glic::CodecConfig> configs;
+    for (const auto& name : presets.getPresetNames()) {
+        configs.push_back(presets.getPreset(name).codecConfig);
+    }
+
+    for (size_t i = 0; i < configs.size(); i++) {
+        glic::CodecConfig copy = configs[i];
+        CHECK(ofxGlic::configEquals(copy, configs[i]));
+        CHECK(ofxGlic::configHash(copy) == ofxGlic::configHash(configs[i]));
+        for (size_t j = i + 1; j < configs.size(); j++) {
+            bool equal = ofxGlic::configEquals(configs[i], configs[j]);
+            bool sameHash = ofxGlic::configHash(configs[i]) == ofxGlic::configHash(configs[j]);
+            CHECK_MESSAGE(equal == sameHash, ofToString(i) + " and " + ofToString(j));
+        }
+    }
+}
+
+// Cycling through the presets only configures glic codecs on the first pass
+OFXGLIC_TEST(configCacheReusesCodecs) {
+    auto& presets = ofxGlicPresets::instance();
+    ofxGlicCodec codec;
+    for (const auto& name : presets.getPresetNames()) {
+        codec.setConfig(presets.getPreset(name).codecConfig);
+    }
+    uint64_t misses = codec.getConfigCacheMisses();
+    for (int pass = 0; pass < 3; pass++) {
+        for (const auto& name : presets.getPresetNames()) {
+            codec.setConfig(presets.getPreset(name).codecConfig);
+        }
+    }
+    CHECK(codec.getConfigCacheMisses() == misses);
+}
+
+OFXGLIC_TEST(sessionMatchesDirectPipeline) {
+    ofPixels source = makeTestPixels(640, 360, OF_PIXELS_RGB);
+    glic::CodecConfig config = ofxGlicPresets::moderate().codecConfig;
+    glic::CodecConfig changed = config;
+    for (auto& channel : changed.channels) channel.quantizationValue += 10;
+    std::vector<ofxGlicEffect> effects = {ofxGlicEffect::scanline(40)};
+    std::vector<ofxGlicEffect> otherEffects = {ofxGlicEffect::scanline(60)};
+
+    ofxGlicCodec codec;
+    ofxGlicEffects effectsProcessor;
+    effectsProcessor.setEffects(effects);
+    ofPixels direct;
+    codec.setConfig(changed);
+    codec.glitch(source, direct);
+    effectsProcessor.apply(direct);
+
+    ofxGlicSession session;
+    session.setSource(source);
+    session.setConfig(config);
+    session.setEffects(otherEffects);
+    session.update();
+    session.setEffects(effects);
+    session.update();
+
+    // Toggling between two configs encodes each once, then reuses the results
+    uint64_t encodesBefore = session.getNumEncodes();
+    for (int i = 0; i < 5; i++) {
+        session.setConfig(i % 2 == 0 ? changed : config);
+        session.update();
+    }
+    CHECK(session.getNumEncodes() - encodesBefore == 1);
+
+    session.setConfig(changed);
+    session.update();
+    CHECK(samePixels(session.getPixels(), direct));
+    CHECK(session.getNumConversions() == 1);
+}
+
+// With threshold 0 only identical tiles are reused, so every frame must
+// match glitching it from scratch
+OFXGLIC_TEST(streamModeMatchesFullEncode) {
+    const int numFrames = 6;
+    std::vector<ofPixels> frames(numFrames);
+    for (int i = 0; i < numFrames; i++) {
+        frames[i] = makeTestPixels(640, 360, OF_PIXELS_RGB);
+        for (int y = 150; y < 200; y++) {
+            for (int x = 50 + i * 40; x < 100 + i * 40; x++) {
+                frames[i].setColor(x, y, ofColor(255, 0, 0));
+            }
+        }
+    }
+
+    ofxGlicCodec codec;
+    codec.setConfig(ofxGlicPresets::moderate().codecConfig);
+    codec.setTiling(true, 128);
+    std::vector<ofPixels> plain(numFrames);
+    for (int i = 0; i < numFrames; i++) {
+        codec.glitch(frames[i], plain[i]);
+    }
+
+    codec.setStreamMode(true, 0.0f);
+    int reused = 0;
+    ofPixels out;
+    for (int i = 0; i < numFrames; i++) {
+        codec.glitch(frames[i], out);
+        CHECK_MESSAGE(samePixels(out, plain[i]), "frame " + ofToString(i));
+        if (i > 0) reused += codec.getStreamTilesReused();
+    }
+    CHECK(reused > 0);
+}
+
+OFXGLIC_TEST(glitchMultiMatchesOneAtATime) {
+    ofPixels source = makeTestPixels(480, 270, OF_PIXELS_RGB);
+    std::vector<ofxGlicPreset> presets;
+    for (const auto& name : ofxGlicPresets::instance().getPresetNames()) {
+        presets.push_back(ofxGlicPresets::instance().getPreset(name));
+    }
+    // Same codec config, different effects: shares one encode with its original
+    ofxGlicPreset scanlined = presets.front();
+    scanlined.name += " Scanlined";
+    scanlined.effects.push_back(ofxGlicEffect::scanline(40));
+    presets.push_back(scanlined);
+
+    ofxGlicCodec codec;
+    std::vector<ofPixels> expected(presets.size());
+    for (size_t i = 0; i < presets.size(); i++) {
+        codec.setConfig(presets[i].codecConfig);
+        codec.glitch(source, expected[i]);
+        for (const auto& effect : presets[i].effects) {
+            ofxGlicEffects::applyEffect(expected[i], effect);
+        }
+    }
+
+    ofxGlicCodec multiCodec;
+    std::vector<ofPixels> outs;
+    multiCodec.glitchMulti(source, presets, outs);
+    CHECK(outs.size() == expected.size());
+    for (size_t i = 0; i < outs.size() && i < expected.size(); i++) {
+        CHECK_MESSAGE(samePixels(outs[i], expected[i]), presets[i].name);
+    }
+}
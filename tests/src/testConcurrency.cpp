@@ -0,0 +1,318 @@
+#include "testing.h"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+using namespace ofxGlicTest;
+
+namespace {
+    // What a preset does to one frame, on the calling thread
+    ofPixels glitchSerial(const ofPixels& source, const ofxGlicPreset& preset) {
+        ofxGlicCodec codec;
+        codec.setConfig(preset.codecConfig);
+        ofPixels result;
+        codec.glitch(source, result);
+        for (const auto& effect : preset.effects) {
+            ofxGlicEffects::applyEffect(result, effect);
+        }
+        return result;
+    }
+
+    uintmax_t fileSize(const std::string& path) {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        return error ? uintmax_t(0) : size;
+    }
+}
+
+// A deep enough queue keeps every frame, and the results match the synchronous codec
+OFXGLIC_TEST(asyncCodecMatchesSyncCodec) {
+    const auto config = ofxGlicPresets::moderate().codecConfig;
+    ofPixels source = makeTestPixels(320, 240, OF_PIXELS_RGB);
+    ofxGlicCodec codec;
+    codec.setConfig(config);
+    ofPixels expected;
+    codec.glitch(source, expected);
+
+    const int frames = 8;
+    ofxGlicAsyncCodec asyncCodec;
+    asyncCodec.setup(2, frames);
+    std::vector<std::future<ofxGlicAsyncResult>> futures;
+    for (int i = 0; i < frames; i++) {
+        futures.push_back(asyncCodec.submit(source, config));
+    }
+    for (auto& future : futures) {
+        ofxGlicAsyncResult result = future.get();
+        CHECK(result.success && samePixels(result.pixels, expected));
+    }
+}
+
+// Producers racing on the first submit start one set of workers, and every
+// frame is either finished or dropped
+OFXGLIC_TEST(asyncCodecStartsFromManyProducers) {
+    const auto config = ofxGlicPresets::moderate().codecConfig;
+    ofPixels source = makeTestPixels(64, 48, OF_PIXELS_RGB);
+    ofxGlicAsyncCodec asyncCodec;
+
+    const int producers = 4, framesEach = 8;
+    std::vector<std::future<ofxGlicAsyncResult>> futures(producers * framesEach);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < framesEach; i++) {
+                futures[p * framesEach + i] = asyncCodec.submit(source, config);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    CHECK(asyncCodec.isRunning());
+
+    for (auto& future : futures) {
+        ofxGlicAsyncResult result = future.get();
+        CHECK(result.success || result.dropped);
+    }
+    ofxGlicAsyncStats stats = asyncCodec.getStats();
+    CHECK(stats.submitted == uint64_t(producers * framesEach));
+    CHECK(stats.completed + stats.dropped == stats.submitted);
+    asyncCodec.close();
+    CHECK(!asyncCodec.isRunning());
+}
+
+OFXGLIC_TEST(codecPoolMatchesNewCodecs) {
+    const int jobs = 16;
+    ofPixels source = makeTestPixels(128, 128, OF_PIXELS_RGBA);
+    const ofxGlicPreset& preset = ofxGlicPresets::instance().getPreset("Moderate");
+    ofxGlicConfigSnapshot snapshot = ofxGlicPresets::instance().getConfigSnapshot("Moderate");
+
+    ofxGlicCodec codec;
+    codec.setConfig(preset.codecConfig);
+    ofPixels expected;
+    codec.glitch(source, expected);
+
+    ofxGlicCodecPool pool;
+    std::vector<ofPixels> outputs(jobs);
+    ofxGlicThreadPool::shared().parallelFor(jobs, [&](size_t i) {
+        pool.glitch(snapshot, source, outputs[i]);
+    });
+    for (const auto& out : outputs) {
+        CHECK(samePixels(out, expected));
+    }
+    CHECK(pool.getNumCodecs() <= ofxGlicThreadPool::shared().getNumThreads() + 1);
+}
+
+// Settings left on a thread's shared codec do not reach the static helpers
+OFXGLIC_TEST(encodeImageIgnoresSharedCodecState) {
+    TempFolder folder("ofxGlicTestEncodeImage");
+    ofImage image;
+    image.setFromPixels(makeTestPixels(300, 200, OF_PIXELS_RGB));
+
+    ofxGlicCodec& shared = ofxGlicCodecPool::shared().get();
+    shared.setTiling(true, 64);
+    shared.setStreamMode(true);
+    std::string path = folder.path("plain.glic");
+    CHECK(ofxGlicCodec::encodeImage(image, path));
+    shared.setTiling(false);
+    shared.setStreamMode(false);
+
+    ofxGlicMappedFile file(path);
+    CHECK(file.isOpen() && !ofxGlic::isTiledStream(file.data(), file.size()));
+    CHECK(ofxGlicCodec::decodeImage(path).success);
+}
+
+OFXGLIC_TEST(batchProcessorMatchesSerialGlitch) {
+    const int numImages = 8;
+    ofxGlicPreset preset = ofxGlicPresets::vhs();
+    ofPixels source = makeTestPixels(256, 256, OF_PIXELS_RGB);
+    std::vector<ofxGlicBatchJob> jobs(numImages);
+    for (auto& job : jobs) job.pixels = source;
+    ofPixels expected = glitchSerial(source, preset);
+
+    ofxGlicThreadPool& pool = ofxGlicThreadPool::shared();
+    for (size_t concurrency : {size_t(1), size_t(2), size_t(0)}) {
+        ofxGlicBatchProcessor batch;
+        batch.setMaxConcurrency(concurrency);
+        uint64_t steals = pool.getNumSteals();
+        batch.start(jobs, preset);
+        batch.wait();
+        CHECK(batch.getNumFinished() == numImages && batch.getNumFailed() == 0);
+        for (const auto& job : batch.getJobs()) {
+            CHECK_MESSAGE(samePixels(job.pixels, expected), ofToString(concurrency) + " at once");
+        }
+
+        // Jobs reach the other pool threads by being stolen from the runner's thread
+        if (concurrency != 1 && pool.getNumThreads() > 1) {
+            CHECK_MESSAGE(pool.getNumSteals() > steals, ofToString(concurrency) + " at once");
+        }
+    }
+
+    // Cancelling skips the jobs that have not started, and every job is accounted for
+    ofxGlicBatchProcessor batch;
+    batch.setMaxConcurrency(1);
+    batch.start(jobs, preset);
+    batch.cancel();
+    batch.wait();
+    size_t cancelled = 0;
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (batch.getJobState(i) == ofxGlicBatchJob::State::Cancelled) cancelled++;
+    }
+    CHECK(batch.getNumFinished() == numImages);
+    CHECK(cancelled > 0);
+}
+
+OFXGLIC_TEST(sequenceExporterWritesAndResumes) {
+    const int numFrames = 12;
+    TempFolder folder("ofxGlicTestExport");
+    ofxGlicExportSettings settings;
+    settings.folder = folder.path();
+
+    ofxGlicSequenceExporter exporter;
+    exporter.start(settings, ofxGlicPresets::vhs());
+    ofPixels frame = makeTestPixels(320, 180, OF_PIXELS_RGB);
+    for (int i = 0; i < numFrames; i++) {
+        exporter.push(frame, i);
+    }
+    exporter.close();
+    exporter.wait();
+
+    ofxGlicExportStats stats = exporter.getStats();
+    CHECK(stats.written == numFrames && stats.failed == 0);
+    CHECK(ofxGlicSequenceExporter::findResumeFrame(settings, numFrames) == numFrames);
+
+    // A missing frame is where an interrupted export resumes
+    std::filesystem::remove(exporter.getFramePath(numFrames / 2));
+    CHECK(ofxGlicSequenceExporter::findResumeFrame(settings, numFrames) == numFrames / 2);
+}
+
+OFXGLIC_TEST(sequenceExporterTryPushNeverWaits) {
+    TempFolder folder("ofxGlicTestTryPush");
+    ofxGlicExportSettings settings;
+    settings.folder = folder.path();
+    settings.numWorkers = 1;
+    settings.queueSize = 2;
+
+    // Producers race for the two slots; the losers are turned away at once
+    ofxGlicSequenceExporter exporter;
+    exporter.start(settings, ofxGlicPresets::vhs());
+    ofPixels frame = makeTestPixels(320, 180, OF_PIXELS_RGB);
+    std::atomic<int> nextIndex{0};
+    std::atomic<int> accepted{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; p++) {
+        producers.emplace_back([&] {
+            for (int i = 0; i < 10; i++) {
+                if (exporter.tryPush(frame, nextIndex++)) accepted++;
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    exporter.close();
+    CHECK(!exporter.tryPush(frame, nextIndex++));
+    exporter.wait();
+
+    ofxGlicExportStats stats = exporter.getStats();
+    CHECK(accepted > 0);
+    CHECK(stats.pushed == uint64_t(accepted) && stats.written == uint64_t(accepted));
+    CHECK(stats.pushWaitMillis == 0);
+}
+
+// Y4M: one header line, then "FRAME\n" before every frame
+OFXGLIC_TEST(frameWriterFileSizes) {
+    const int numFrames = 5;
+    const int width = 320, height = 180;
+    TempFolder folder("ofxGlicTestWriter");
+    ofPixels frame = makeTestPixels(width, height, OF_PIXELS_RGB);
+
+    struct Variant {
+        const char* name;
+        ofxGlicFrameFormat format;
+        bool async;
+        int syncInterval;
+    };
+    const Variant variants[] = {
+        {"y4m", ofxGlicFrameFormat::Y4M, false, 0},
+        {"y4m 4:2:0", ofxGlicFrameFormat::Y4M420, false, 0},
+        {"rgba", ofxGlicFrameFormat::RGBA, false, 0},
+        {"y4m async", ofxGlicFrameFormat::Y4M, true, 0},
+        {"y4m sync/2", ofxGlicFrameFormat::Y4M, false, 2},
+    };
+    for (size_t v = 0; v < std::size(variants); v++) {
+        const Variant& variant = variants[v];
+        ofxGlicFrameWriterSettings settings;
+        settings.format = variant.format;
+        settings.async = variant.async;
+        settings.syncInterval = variant.syncInterval;
+        std::string path = folder.path("frames" + ofToString(v) + "." +
+                                       ofxGlicFrameWriter::getExtension(variant.format));
+
+        ofxGlicFrameWriter writer;
+        bool ok = writer.open(path, width, height, settings);
+        for (int i = 0; ok && i < numFrames; i++) {
+            ok = writer.write(frame);
+        }
+        ok = writer.close() && ok;
+        CHECK_MESSAGE(ok, variant.name);
+
+        size_t headers = 0;
+        if (variant.format != ofxGlicFrameFormat::RGBA) {
+            std::ifstream file(path, std::ios::binary);
+            std::string headerLine;
+            std::getline(file, headerLine);
+            headers = headerLine.size() + 1 + numFrames * 6;
+        }
+        size_t frameBytes = ofxGlicFrameWriter::getFrameSize(variant.format, width, height);
+        CHECK_MESSAGE(fileSize(path) == headers + numFrames * frameBytes, variant.name);
+        CHECK_MESSAGE(writer.getBytesWritten() == fileSize(path), variant.name);
+
+        // Raw RGBA holds the exact pixels
+        if (variant.format == ofxGlicFrameFormat::RGBA) {
+            ofPixels rgba = frame;
+            rgba.setImageType(OF_IMAGE_COLOR_ALPHA);
+            std::ifstream file(path, std::ios::binary);
+            std::vector<char> firstFrame(rgba.getTotalBytes());
+            file.read(firstFrame.data(), firstFrame.size());
+            CHECK(file && std::memcmp(firstFrame.data(), rgba.getData(), firstFrame.size()) == 0);
+        }
+    }
+}
+
+// The exporter's stream mode puts frames finished out of order into the
+// same file as writing them one by one
+OFXGLIC_TEST(exporterStreamKeepsFrameOrder) {
+    const int numFrames = 12;
+    TempFolder folder("ofxGlicTestStream");
+    ofxGlicPreset preset = ofxGlicPresets::vhs();
+    std::vector<ofPixels> sources(numFrames);
+    for (int i = 0; i < numFrames; i++) {
+        sources[i] = makeTestPixels(320, 180, OF_PIXELS_RGB);
+        sources[i].getData()[i * 3] = 255 - sources[i].getData()[i * 3];
+    }
+
+    ofxGlicExportSettings settings;
+    settings.folder = folder.path("export");
+    settings.numWorkers = 3;
+    settings.streamOutput = true;
+    ofxGlicSequenceExporter exporter;
+    exporter.start(settings, preset);
+    for (int i = 0; i < numFrames; i++) {
+        exporter.push(sources[i], i);
+    }
+    exporter.close();
+    exporter.wait();
+
+    ofxGlicFrameWriter reference;
+    std::string referencePath = folder.path("reference.y4m");
+    for (int i = 0; i < numFrames; i++) {
+        ofPixels result = glitchSerial(sources[i], preset);
+        if (i == 0) reference.open(referencePath, result.getWidth(), result.getHeight());
+        reference.write(result);
+    }
+    reference.close();
+
+    ofxGlicMappedFile exported(ofxGlicSequenceExporter::getStreamPath(settings));
+    ofxGlicMappedFile expected(referencePath);
+    CHECK(exported.isOpen() && expected.isOpen());
+    CHECK(exported.size() == expected.size() && std::memcmp(exported.data(), expected.data(), expected.size()) == 0);
+}
@@ -0,0 +1,270 @@
+#include "testing.h"
+
+using namespace ofxGlicTest;
+
+namespace {
+    const std::vector<ofPixelFormat> effectFormats = {OF_PIXELS_RGB, OF_PIXELS_BGR, OF_PIXELS_RGBA, OF_PIXELS_BGRA,
+                                                      OF_PIXELS_GRAY, OF_PIXELS_GRAY_ALPHA};
+
+    // Pixelate the part of region inside the frame block by block, each
+    // block filled with the truncated mean of its color channels, summed
+    // pixel by pixel; alpha is kept
+    void pixelateReference(ofPixels& pixels, const ofRectangle& region, int blockWidth, int blockHeight) {
+        int x0, y0, x1, y1;
+        if (!ofxGlic::clipRegion(region, pixels.getWidth(), pixels.getHeight(), x0, y0, x1, y1)) return;
+        blockWidth = std::max(1, blockWidth);
+        blockHeight = std::max(1, blockHeight);
+
+        const size_t stride = pixels.getNumChannels();
+        const size_t colorChannels = stride <= 2 ? 1 : 3;
+        const size_t width = pixels.getWidth();
+        uint8_t* data = pixels.getData();
+        for (int by = y0; by < y1; by += blockHeight) {
+            int ey = std::min(y1, by + blockHeight);
+            for (int bx = x0; bx < x1; bx += blockWidth) {
+                int ex = std::min(x1, bx + blockWidth);
+                uint32_t count = uint32_t(ex - bx) * uint32_t(ey - by);
+                for (size_t c = 0; c < colorChannels; c++) {
+                    uint32_t sum = 0;
+                    for (int y = by; y < ey; y++) {
+                        for (int x = bx; x < ex; x++) sum += data[(y * width + x) * stride + c];
+                    }
+                    for (int y = by; y < ey; y++) {
+                        for (int x = bx; x < ex; x++) data[(y * width + x) * stride + c] = uint8_t(sum / count);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Fused chains give the same pixels as each effect through glic
+OFXGLIC_TEST(effectChainsMatchGlic) {
+    ofPixels source = makeTestPixels(320, 240, OF_PIXELS_RGB);
+    ofxGlicWorkspace workspace;
+    for (const auto& name : ofxGlicPresets::instance().getPresetNames()) {
+        const ofxGlicPreset& preset = ofxGlicPresets::instance().getPreset(name);
+        ofPixels expected = source;
+        for (const auto& effect : preset.effects) {
+            applyEffectGlic(expected, effect);
+        }
+        ofPixels result = source;
+        ofxGlicEffects::applyEffects(result, preset.effects, workspace);
+        CHECK_MESSAGE(samePixels(result, expected), name);
+    }
+}
+
+// Native kernels only replace glic where they give its result
+OFXGLIC_TEST(nativeEffectsMatchGlic) {
+    const std::vector<ofxGlicEffect> effects = {
+        ofxGlicEffect::pixelate(8), ofxGlicEffect::pixelate(5), ofxGlicEffect::scanline(50),
+        ofxGlicEffect::chromatic(3, 1), ofxGlicEffect::chromatic(-2, -9), ofxGlicEffect::dither(50),
+        ofxGlicEffect::posterize(4), ofxGlicEffect::glitchShift(8, 12345)};
+    ofxGlicWorkspace workspace;
+    for (auto format : effectFormats) {
+        ofPixels source = makeTestPixels(331, 197, format);
+        for (const auto& effect : effects) {
+            ofPixels expected = source;
+            applyEffectGlic(expected, effect);
+            ofPixels result = source;
+            ofxGlicEffects::applyEffect(result, effect, workspace);
+            CHECK_MESSAGE(samePixels(result, expected),
+                          ofxGlicEffects::getEffectName(effect.type) + " " + formatName(format));
+        }
+    }
+}
+
+// Row bands give the same result for any thread count
+OFXGLIC_TEST(effectThreadsAreDeterministic) {
+    ofPixels source = makeTestPixels(1280, 720, OF_PIXELS_RGB);
+    ofxGlicWorkspace workspace;
+    const std::vector<std::pair<std::string, std::vector<ofxGlicEffect>>> chains = {
+        {"VHS", ofxGlicPresets::instance().getPreset("VHS").effects},
+        {"Retro", ofxGlicPresets::instance().getPreset("Retro").effects},
+        {"pixelate(7)", {ofxGlicEffect::pixelate(7)}},
+        {"pixelate(16, 5)", {ofxGlicEffect::pixelate(16, 5)}},
+        {"chromatic(3, 5)", {ofxGlicEffect::chromatic(3, 5)}},
+        {"chromatic(-2, -9)", {ofxGlicEffect::chromatic(-2, -9)}},
+        {"chromatic(4, 150)", {ofxGlicEffect::chromatic(4, 150)}},
+        {"glitchShift(5)", {ofxGlicEffect::glitchShift(5, 777)}}};
+
+    for (const auto& chain : chains) {
+        ofPixels single = source;
+        ofxGlicEffects::applyEffects(single, chain.second, workspace, 1);
+        for (size_t threads : {0, 2, 3, 7}) {
+            ofPixels result = source;
+            ofxGlicEffects::applyEffects(result, chain.second, workspace, threads);
+            CHECK_MESSAGE(samePixels(result, single), chain.first + ", " + ofToString(threads) + " threads");
+        }
+    }
+}
+
+// On [0, 1] float kernels agree with the 8-bit chain to within one 8-bit
+// step per effect, which glic loses to truncation; alpha is exact
+OFXGLIC_TEST(floatEffectsMatch8Bit) {
+    const std::vector<std::pair<std::string, std::vector<ofxGlicEffect>>> chains = {
+        {"VHS", ofxGlicPresets::instance().getPreset("VHS").effects},
+        {"Retro", ofxGlicPresets::instance().getPreset("Retro").effects},
+        {"pixelate(5)", {ofxGlicEffect::pixelate(5)}},
+        {"pixelate(16, 5)", {ofxGlicEffect::pixelate(16, 5)}},
+        {"scanline(50)", {ofxGlicEffect::scanline(50)}},
+        {"chromatic(-2, -9)", {ofxGlicEffect::chromatic(-2, -9)}},
+        {"dither(70)", {ofxGlicEffect::dither(70)}},
+        {"posterize(5)", {ofxGlicEffect::posterize(5)}},
+        {"glitchShift(5)", {ofxGlicEffect::glitchShift(5, 777)}}};
+    ofxGlicWorkspace workspace;
+    for (auto format : effectFormats) {
+        ofPixels source = makeTestPixels(640, 360, format);
+        const size_t channels = source.getNumChannels();
+        const bool hasAlpha = format == OF_PIXELS_RGBA || format == OF_PIXELS_BGRA || format == OF_PIXELS_GRAY_ALPHA;
+        for (const auto& chain : chains) {
+            ofPixels expected = source;
+            ofxGlicEffects::applyEffects(expected, chain.second, workspace);
+
+            ofFloatPixels pixels;
+            pixels.allocate(640, 360, format);
+            for (size_t i = 0; i < pixels.size(); i++) {
+                pixels[i] = source[i] / 255.0f;
+            }
+            ofxGlicEffects::applyEffects(pixels, chain.second, workspace, 3);
+
+            const float steps = float(chain.second.size()) + 0.001f;
+            bool close = true;
+            for (size_t i = 0; i < expected.size(); i++) {
+                float value = std::min(1.0f, std::max(0.0f, pixels[i])) * 255.0f;
+                if (hasAlpha && i % channels == channels - 1) {
+                    close = close && value == expected[i];
+                } else {
+                    close = close && std::fabs(value - expected[i]) <= steps;
+                }
+            }
+            CHECK_MESSAGE(close, chain.first + " " + formatName(format));
+        }
+    }
+}
+
+// Float kernels keep values outside [0, 1] and take their scratch from the workspace
+OFXGLIC_TEST(floatEffectsKeepHdr) {
+    ofxGlicWorkspace workspace;
+    auto fill = [](ofFloatPixels& pixels, float value) {
+        pixels.allocate(64, 32, OF_PIXELS_RGB);
+        for (size_t i = 0; i < pixels.size(); i++) pixels[i] = value;
+    };
+
+    ofFloatPixels scanline;
+    fill(scanline, 3.0f);
+    ofxGlicEffects::applyEffects(scanline, {ofxGlicEffect::scanline(50)}, workspace);
+    CHECK(scanline[0] == 3.0f && scanline[64 * 3] == 1.5f);
+
+    ofFloatPixels posterize;
+    fill(posterize, -1.0f);
+    ofxGlicEffects::applyEffects(posterize, {ofxGlicEffect::posterize(4)}, workspace);
+    CHECK(posterize[0] == -1.0f);
+
+    ofFloatPixels pixelate;
+    fill(pixelate, 2.0f);
+    pixelate[0] = 6.0f;
+    ofxGlicEffects::applyEffects(pixelate, {ofxGlicEffect::pixelate(2)}, workspace);
+    CHECK(pixelate[0] == 3.0f && pixelate[3] == 3.0f && pixelate[64 * 3] == 3.0f && pixelate[6] == 2.0f);
+    CHECK(workspace.getCapacityBytes() > 0);
+
+    ofFloatPixels chromatic;
+    fill(chromatic, 0.5f);
+    chromatic[5 * 3] = 4.0f;
+    ofxGlicEffects::applyEffects(chromatic, {ofxGlicEffect::chromatic(3, 0)}, workspace);
+    CHECK(chromatic[8 * 3] == 4.0f && chromatic[5 * 3] == 0.5f);
+
+    // Rows are rotated, so every value survives
+    ofFloatPixels shifted;
+    fill(shifted, 0.0f);
+    for (size_t i = 0; i < shifted.size(); i++) shifted[i] = 2.0f + float(i % (64 * 3));
+    ofFloatPixels original = shifted;
+    ofxGlicEffects::applyEffects(shifted, {ofxGlicEffect::glitchShift(4, 12345)}, workspace);
+    bool rotated = std::memcmp(shifted.getData(), original.getData(), shifted.size() * sizeof(float)) != 0;
+    for (size_t y = 0; y < 32; y++) {
+        std::vector<float> before(&original[y * 64 * 3], &original[(y + 1) * 64 * 3]);
+        std::vector<float> after(&shifted[y * 64 * 3], &shifted[(y + 1) * 64 * 3]);
+        std::sort(before.begin(), before.end());
+        std::sort(after.begin(), after.end());
+        rotated = rotated && before == after;
+    }
+    CHECK(rotated);
+}
+
+// Every SIMD level gives the bytes of the scalar lookups, including widths
+// that leave a scalar tail and every layout the kernels map
+OFXGLIC_TEST(simdEffectsAreBitExact) {
+    const ofxGlic::SimdLevel defaultLevel = ofxGlic::getSimdLevel();
+    const std::vector<ofxGlic::SimdLevel> levels = {ofxGlic::SimdLevel::SSE2, ofxGlic::SimdLevel::SSSE3,
+                                                    ofxGlic::SimdLevel::AVX2, ofxGlic::SimdLevel::NEON};
+    const std::vector<std::pair<std::string, std::vector<ofxGlicEffect>>> chains = {
+        {"posterize(4)", {ofxGlicEffect::posterize(4)}},
+        {"scanline(40)", {ofxGlicEffect::scanline(40)}},
+        {"dither(40)", {ofxGlicEffect::dither(40)}},
+        {"scanline(30) + dither(40)", {ofxGlicEffect::scanline(30), ofxGlicEffect::dither(40)}},
+        {"Retro", ofxGlicPresets::instance().getPreset("Retro").effects}};
+    ofxGlicWorkspace workspace;
+
+    for (auto format : effectFormats) {
+        for (int width : {1, 7, 33, 641}) {
+            ofPixels source = makeTestPixels(width, 9, format);
+            for (const auto& chain : chains) {
+                ofxGlic::setSimdLevel(ofxGlic::SimdLevel::SCALAR);
+                ofPixels expected = source;
+                ofxGlicEffects::applyEffects(expected, chain.second, workspace);
+
+                for (auto level : levels) {
+                    if (!ofxGlic::setSimdLevel(level)) continue;
+                    ofPixels result = source;
+                    ofxGlicEffects::applyEffects(result, chain.second, workspace);
+                    CHECK_MESSAGE(samePixels(result, expected), ofxGlic::getSimdLevelName(level) + " " +
+                                  chain.first + " " + formatName(format) + " width " + ofToString(width));
+                }
+            }
+        }
+    }
+    ofxGlic::setSimdLevel(defaultLevel);
+}
+
+// Non-square blocks have no glic counterpart; the reference computes the
+// same block means pixel by pixel
+OFXGLIC_TEST(nonSquarePixelateMatchesReference) {
+    ofxGlicWorkspace workspace;
+    for (auto format : effectFormats) {
+        ofPixels source = makeTestPixels(333, 211, format);
+        for (const auto& block : std::vector<std::pair<int, int>>{{16, 4}, {3, 24}, {1, 7}}) {
+            ofPixels result = source;
+            ofxGlicEffects::applyEffect(result, ofxGlicEffect::pixelate(block.first, block.second), workspace);
+            ofPixels expected = source;
+            pixelateReference(expected, ofRectangle(0, 0, 333, 211), block.first, block.second);
+            CHECK_MESSAGE(samePixels(result, expected), formatName(format) + " " + ofToString(block.first) + "x" +
+                          ofToString(block.second));
+        }
+    }
+}
+
+// Regions apply in order, clipped to the frame, as pixelating each in the
+// frame the regions before it left
+OFXGLIC_TEST(pixelateRegionsMatchReference) {
+    std::vector<ofxGlicPixelateRegion> regions(4);
+    regions[0].area.set(-10, -5, 400, 100);
+    regions[0].blockWidth = 17;
+    regions[0].blockHeight = 9;
+    regions[1].area.set(20.5f, 30.2f, 100.1f, 150.7f);
+    regions[1].blockWidth = 3;
+    regions[1].blockHeight = 5;
+    regions[2].area.set(300, 180, 100, 100);
+    regions[2].blockWidth = regions[2].blockHeight = 5000;
+    regions[3].area.set(500, 500, 10, 10);
+
+    ofxGlicWorkspace workspace;
+    for (auto format : effectFormats) {
+        ofPixels result = makeTestPixels(333, 211, format);
+        ofPixels expected = result;
+        CHECK(ofxGlicEffects::pixelateRegions(result, regions, workspace));
+        for (const auto& region : regions) {
+            pixelateReference(expected, region.area, region.blockWidth, region.blockHeight);
+        }
+        CHECK_MESSAGE(samePixels(result, expected), formatName(format));
+    }
+}
@@ -0,0 +1,79 @@
+#include "testing.h"
+
+using namespace ofxGlicTest;
+
+namespace {
+    // Per-pixel conversion loops the addon used before ofxGlicPixels
+    void legacyToGlicColors(const ofPixels& pixels, std::vector<glic::Color>& colors) {
+        int width = pixels.getWidth();
+        int height = pixels.getHeight();
+        colors.resize(width * height);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                ofColor c = pixels.getColor(x, y);
+                colors[y * width + x] = glic::makeColor(c.r, c.g, c.b, c.a);
+            }
+        }
+    }
+
+    void legacyToOfPixels(const std::vector<glic::Color>& colors, int width, int height, ofPixels& pixels) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                glic::Color c = colors[y * width + x];
+                pixels.setColor(x, y, ofColor(glic::getR(c), glic::getG(c), glic::getB(c), glic::getA(c)));
+            }
+        }
+    }
+
+    const std::vector<ofxGlic::SimdLevel> simdLevels = {
+        ofxGlic::SimdLevel::SCALAR, ofxGlic::SimdLevel::SSE2, ofxGlic::SimdLevel::SSSE3,
+        ofxGlic::SimdLevel::AVX2, ofxGlic::SimdLevel::NEON};
+}
+
+OFXGLIC_TEST(pixelConversionMatchesLegacyLoops) {
+    for (auto format : {OF_PIXELS_RGBA, OF_PIXELS_BGRA, OF_PIXELS_RGB, OF_PIXELS_BGR, OF_PIXELS_GRAY}) {
+        ofPixels source = makeTestPixels(321, 47, format);
+        std::vector<glic::Color> expected, colors;
+        legacyToGlicColors(source, expected);
+        ofxGlic::toGlicColors(source, colors);
+        CHECK_MESSAGE(colors == expected, formatName(format));
+
+        ofPixels expectedOut = source;
+        ofPixels out = source;
+        legacyToOfPixels(expected, 321, 47, expectedOut);
+        ofxGlic::toOfPixels(colors.data(), 321, 47, out);
+        CHECK_MESSAGE(samePixels(out, expectedOut), formatName(format));
+
+        ofxGlicColorView view(source);
+        CHECK_MESSAGE(std::equal(expected.begin(), expected.end(), view.data()), formatName(format));
+    }
+}
+
+// Odd widths exercise the scalar tails of the vector loops
+OFXGLIC_TEST(simdConversionIsBitExact) {
+    const ofxGlic::SimdLevel defaultLevel = ofxGlic::getSimdLevel();
+    for (auto format : {OF_PIXELS_RGB, OF_PIXELS_BGR, OF_PIXELS_RGBA, OF_PIXELS_BGRA}) {
+        for (int width : {1, 7, 33, 641}) {
+            ofPixels source = makeTestPixels(width, 3, format);
+            std::vector<glic::Color> expected;
+            legacyToGlicColors(source, expected);
+            ofPixels expectedOut = source;
+            legacyToOfPixels(expected, width, 3, expectedOut);
+
+            for (auto level : simdLevels) {
+                if (!ofxGlic::setSimdLevel(level)) continue;
+                std::vector<glic::Color> colors;
+                ofxGlic::toGlicColors(source, colors);
+                ofPixels out;
+                out.allocate(width, 3, format);
+                ofxGlic::toOfPixels(colors.data(), width, 3, out);
+
+                std::string context = ofxGlic::getSimdLevelName(level) + " " + formatName(format) + " width " +
+                                      ofToString(width);
+                CHECK_MESSAGE(colors == expected, context);
+                CHECK_MESSAGE(samePixels(out, expectedOut), context);
+            }
+        }
+    }
+    ofxGlic::setSimdLevel(defaultLevel);
+}
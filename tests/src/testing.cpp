@@ -0,0 +1,109 @@
+#include "testing.h"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+    struct Test {
+        std::string name;
+        std::function<void()> fn;
+    };
+
+    std::vector<Test>& getTests() {
+        static std::vector<Test> tests;
+        return tests;
+    }
+
+    size_t numFailures = 0;  // In the running test
+}
+
+namespace ofxGlicTest {
+
+bool registerTest(const std::string& name, std::function<void()> fn) {
+    getTests().push_back({name, std::move(fn)});
+    return true;
+}
+
+int runTests(const std::string& filter) {
+    int failed = 0;
+    int run = 0;
+    for (const auto& test : getTests()) {
+        if (test.name.find(filter) == std::string::npos) continue;
+        numFailures = 0;
+        uint64_t start = ofGetElapsedTimeMicros();
+        test.fn();
+        double millis = (ofGetElapsedTimeMicros() - start) / 1000.0;
+        std::cout << (numFailures == 0 ? "[ OK ] " : "[FAIL] ") << test.name << " (" << ofToString(millis, 0)
+                  << " ms)" << std::endl;
+        if (numFailures > 0) failed++;
+        run++;
+    }
+    std::cout << run - failed << " of " << run << " tests passed" << std::endl;
+    return failed;
+}
+
+void fail(const std::string& message, const char* file, int line) {
+    numFailures++;
+    std::cout << "  " << file << ":" << line << ": " << message << std::endl;
+}
+
+ofPixels makeTestPixels(int width, int height, ofPixelFormat format, uint32_t seed) {
+    ofPixels pixels;
+    pixels.allocate(width, height, format);
+
+    uint32_t state = seed;
+    unsigned char* data = pixels.getData();
+    size_t channels = pixels.getNumChannels();
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            for (size_t c = 0; c < channels; c++) {
+                state = state * 1664525u + 1013904223u;
+                int gradient = (c % 2 == 0) ? (x * 255 / width) : (y * 255 / height);
+                *data++ = (unsigned char)((gradient + (state >> 28)) & 0xFF);
+            }
+        }
+    }
+    return pixels;
+}
+
+bool samePixels(const ofPixels& a, const ofPixels& b) {
+    return a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight() &&
+           a.getPixelFormat() == b.getPixelFormat() &&
+           std::memcmp(a.getData(), b.getData(), a.getTotalBytes()) == 0;
+}
+
+std::string formatName(ofPixelFormat format) {
+    switch (format) {
+        case OF_PIXELS_GRAY: return "GRAY";
+        case OF_PIXELS_GRAY_ALPHA: return "GRAY_ALPHA";
+        case OF_PIXELS_RGB: return "RGB";
+        case OF_PIXELS_BGR: return "BGR";
+        case OF_PIXELS_RGBA: return "RGBA";
+        case OF_PIXELS_BGRA: return "BGRA";
+        default: return "OTHER";
+    }
+}
+
+void applyEffectGlic(ofPixels& pixels, const ofxGlicEffect& effect) {
+    std::vector<glic::Color> colors;
+    ofxGlic::toGlicColors(pixels, colors);
+    glic::applyEffect(colors, pixels.getWidth(), pixels.getHeight(), effect.toGlic());
+    ofxGlic::toOfPixels(colors.data(), pixels.getWidth(), pixels.getHeight(), pixels);
+}
+
+TempFolder::TempFolder(const std::string& name) {
+    path_ = (std::filesystem::temp_directory_path() / name).string();
+    std::filesystem::remove_all(path_);
+    std::filesystem::create_directories(path_);
+}
+
+TempFolder::~TempFolder() {
+    std::error_code error;
+    std::filesystem::remove_all(path_, error);
+}
+
+std::string TempFolder::path(const std::string& file) const {
+    return file.empty() ? path_ : (std::filesystem::path(path_) / file).string();
+}
+
+}
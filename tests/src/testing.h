@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxGlic.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal runner for the ofxGlic correctness tests
+// OFXGLIC_TEST(name) defines and registers a test; CHECK records a failure
+// with its location and lets the test go on, so one run lists every
+// difference. The tests link against the real glic-cpp, so comparisons
+// with glic::applyEffect and GlicCodec check the addon against the library.
+
+namespace ofxGlicTest {
+    bool registerTest(const std::string& name, std::function<void()> fn);
+
+    // Runs the tests whose name contains filter; returns the number that failed
+    int runTests(const std::string& filter);
+
+    void fail(const std::string& message, const char* file, int line);
+
+    // Deterministic test frame: gradients with some noise on top
+    ofPixels makeTestPixels(int width, int height, ofPixelFormat format, uint32_t seed = 0x12345678);
+
+    bool samePixels(const ofPixels& a, const ofPixels& b);
+
+    std::string formatName(ofPixelFormat format);
+
+    // One effect through glic colors and back, the path the native kernels replace
+    void applyEffectGlic(ofPixels& pixels, const ofxGlicEffect& effect);
+
+    // Empty folder under the system temp directory, removed by the destructor
+    class TempFolder {
+    public:
+        explicit TempFolder(const std::string& name);
+        ~TempFolder();
+
+        std::string path(const std::string& file = "") const;
+
+    private:
+        std::string path_;
+    };
+}
+
+#define OFXGLIC_TEST(name) \
+    static void name(); \
+    static const bool name##Registered = ofxGlicTest::registerTest(#name, name); \
+    static void name()
+
+#define CHECK(expression) \
+    do { \
+        if (!(expression)) ofxGlicTest::fail(#expression, __FILE__, __LINE__); \
+    } while (0)
+
+// Same, with context for checks inside loops
+#define CHECK_MESSAGE(expression, message) \
+    do { \
+        if (!(expression)) ofxGlicTest::fail(std::string(#expression) + " (" + (message) + ")", __FILE__, __LINE__); \
+    } while (0)